@@ -0,0 +1,82 @@
+// src/cpp -> public/wasm 빌드 (Emscripten 필요)
+const { execFileSync } = require('child_process');
+const fs = require('fs');
+const path = require('path');
+
+const SRC_DIR = path.join(__dirname, 'src', 'cpp');
+const OUT_DIR = path.join(__dirname, 'public', 'wasm');
+
+const MODULES = [
+    {
+        name: 'image-kernels',
+        sources: ['alpha_choke.cpp', 'mask_upsample.cpp', 'webp_lossless.cpp'],
+        exports: ['malloc', 'free', 'choke_alpha_rgba', 'guided_upsample_alpha', 'webp_encode_lossless'],
+    },
+    {
+        name: 'visual-odometry',
+        sources: ['visual_odometry.cpp'],
+        exports: ['vo_init', 'vo_frame_buffer', 'vo_track_frame', 'vo_homography', 'vo_confidence', 'vo_reset_anchor', 'vo_shutdown'],
+    },
+];
+
+const COMMON_FLAGS = [
+    '-O3',
+    '-std=c++17',
+    '-fno-exceptions',
+    '-fno-rtti',
+    '--no-entry',
+    '-sSTANDALONE_WASM=1',
+    '-sALLOW_MEMORY_GROWTH=1',
+    '-sINITIAL_MEMORY=16MB',
+];
+
+// 모듈마다 두 가지 변형을 만들고 public/wasm/loader.js 가 실행 시점에 고른다
+//   <name>.wasm          SIMD 없음 (모든 Wasm 런타임)
+//   <name>.simd.wasm     SIMD128
+// 커널은 단일 스레드라 공유 메모리(atomics) 변형은 만들지 않는다. pthread 변형은 Emscripten 의
+// 스레드 JS 글루가 필요한데 loader.js 는 STANDALONE_WASM 을 빈 import 로 직접 인스턴스화한다.
+const VARIANTS = [
+    { suffix: '', flags: [] },
+    { suffix: '.simd', flags: ['-msimd128'] },
+];
+
+function emscriptenAvailable() {
+    try {
+        execFileSync('em++', ['--version'], { stdio: 'ignore' });
+        return true;
+    } catch (e) {
+        return false;
+    }
+}
+
+function build(mod, variant) {
+    const out = path.join(OUT_DIR, mod.name + variant.suffix + '.wasm');
+    const args = [
+        ...COMMON_FLAGS,
+        ...variant.flags,
+        '-I' + SRC_DIR,
+        '-sEXPORTED_FUNCTIONS=' + mod.exports.map((e) => '_' + e).join(','),
+        ...mod.sources.map((s) => path.join(SRC_DIR, s)),
+        '-o', out,
+    ];
+    execFileSync('em++', args, { stdio: 'inherit' });
+    console.log('Wasm build:', path.relative(__dirname, out), fs.statSync(out).size, 'bytes');
+}
+
+// optional 이면 em++ 가 없을 때 빌드를 건너뛴다 (kernels.js 는 JS 경로로 동작한다)
+function buildAll({ optional = false } = {}) {
+    if (!emscriptenAvailable()) {
+        if (!optional) throw new Error('em++ not found: install and activate the Emscripten SDK');
+        console.warn('em++ not found: skipping Wasm build');
+        return false;
+    }
+    fs.mkdirSync(OUT_DIR, { recursive: true });
+    for (const mod of MODULES) {
+        for (const variant of VARIANTS) build(mod, variant);
+    }
+    return true;
+}
+
+module.exports = { buildAll };
+
+if (require.main === module) buildAll();
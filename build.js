@@ -1,3 +1,156 @@
+const crypto = require('crypto');
 const fs = require('fs');
-fs.cpSync('public', 'dist', { recursive: true });
-console.log('Build complete: public -> dist');
+const path = require('path');
+const zlib = require('zlib');
+const { buildAll: buildWasm } = require('./build-wasm');
+
+const PUBLIC_DIR = path.join(__dirname, 'public');
+const VENDOR_DIR = path.join(PUBLIC_DIR, 'vendor', 'imgly');
+
+// 배경 제거 라이브러리와 모델/런타임 자산을 public/vendor 로 받아 온다
+const BG_LIBRARY_VERSION = '1.5.1';
+const JSDELIVR = 'https://cdn.jsdelivr.net';
+const BG_LIBRARY_ENTRY = `/npm/@imgly/background-removal@${BG_LIBRARY_VERSION}/+esm`;
+const BG_DATA_BASE = `https://staticimgly.com/@imgly/background-removal-data/${BG_LIBRARY_VERSION}/dist/`;
+
+// 미리 압축해 둘 파일 (이미지는 이미 압축돼 있으므로 제외)
+const COMPRESS_SKIP = new Set(['.png', '.jpg', '.jpeg', '.gif', '.webp', '.avif', '.br', '.gz', '.ait']);
+const COMPRESS_MIN_BYTES = 1024;
+
+function contentHash(buf) {
+    return crypto.createHash('sha256').update(buf).digest('hex').slice(0, 16);
+}
+
+async function fetchBuffer(url) {
+    const res = await fetch(url);
+    if (!res.ok) throw new Error(`${url}: HTTP ${res.status}`);
+    return Buffer.from(await res.arrayBuffer());
+}
+
+// import / export ... from / import() 의 문자열 지정자만 잡는다 (주석이나 문자열 속 "/npm/..." 경로는 건드리지 않는다)
+const IMPORT_SPECIFIER = /(\bimport\s*\(\s*|\b(?:import|export)\s*(?:[^'"`;()]*?\bfrom\s*)?)(['"])([^'"\n]+)\2/g;
+
+// jsDelivr +esm 모듈은 의존성을 "/npm/..." 절대 경로로 import 한다. 상대 경로도 모듈 URL 기준으로 풀어서 받는다.
+// 의존성부터 받아 내용 해시 파일명으로 저장하고 import 경로를 로컬 파일로 바꾼다.
+// 받는 순서가 깊이 우선이라 진행 중인 모듈을 다시 만나면 순환이다. 그 모듈은 내용이 아직 정해지지 않았으므로
+// 파일명을 URL 해시로 정해 끊는다 (버전이 고정된 URL 이라 같은 URL 이면 내용도 같다).
+function createModuleVendor(outDir) {
+    const modules = new Map();   // URL -> { inProgress, stableName, promise }
+
+    function vendorModule(url) {
+        let mod = modules.get(url);
+        if (mod) {
+            if (!mod.inProgress) return mod.promise;
+            mod.stableName = contentHash(url) + '.mjs';
+            return Promise.resolve(mod.stableName);
+        }
+        mod = { inProgress: true, stableName: null, promise: null };
+        modules.set(url, mod);
+        mod.promise = (async () => {
+            let source = (await fetchBuffer(url)).toString('utf8');
+            const names = new Map();
+            for (const match of source.matchAll(IMPORT_SPECIFIER)) {
+                const specifier = match[3];
+                if (names.has(specifier)) continue;
+                const local = specifier.startsWith('/') || specifier.startsWith('./') || specifier.startsWith('../');
+                if (!local && !specifier.startsWith(JSDELIVR + '/')) {
+                    if (!/^(https?|data|blob):/.test(specifier)) console.warn(`Vendor: bare import "${specifier}" left as is in ${url}`);
+                    continue;
+                }
+                names.set(specifier, await vendorModule(new URL(specifier, url).href));
+            }
+            source = source.replace(IMPORT_SPECIFIER, (whole, head, quote, specifier) =>
+                names.has(specifier) ? `${head}${quote}./${names.get(specifier)}${quote}` : whole);
+            const fileName = mod.stableName || contentHash(source) + '.mjs';
+            fs.writeFileSync(path.join(outDir, fileName), source);
+            mod.inProgress = false;
+            return fileName;
+        })();
+        return mod.promise;
+    }
+    return vendorModule;
+}
+
+async function vendorBackgroundRemoval() {
+    const libDir = path.join(VENDOR_DIR, 'lib');
+    const dataDir = path.join(VENDOR_DIR, 'data', BG_LIBRARY_VERSION);
+    fs.rmSync(VENDOR_DIR, { recursive: true, force: true });
+    fs.mkdirSync(libDir, { recursive: true });
+    fs.mkdirSync(dataDir, { recursive: true });
+
+    const entry = await createModuleVendor(libDir)(JSDELIVR + BG_LIBRARY_ENTRY);
+
+    // 모델/onnxruntime 청크는 파일명이 이미 내용 해시다
+    const resourcesJson = await fetchBuffer(BG_DATA_BASE + 'resources.json');
+    fs.writeFileSync(path.join(dataDir, 'resources.json'), resourcesJson);
+    const chunks = new Set();
+    for (const resource of Object.values(JSON.parse(resourcesJson))) {
+        for (const chunk of resource.chunks || []) chunks.add(chunk.name || chunk.hash);
+    }
+    for (const name of chunks) {
+        fs.writeFileSync(path.join(dataDir, name), await fetchBuffer(BG_DATA_BASE + name));
+    }
+
+    const manifest = {
+        version: BG_LIBRARY_VERSION,
+        library: `vendor/imgly/lib/${entry}`,
+        publicPath: `vendor/imgly/data/${BG_LIBRARY_VERSION}/`,
+    };
+    fs.writeFileSync(path.join(VENDOR_DIR, 'manifest.json'), JSON.stringify(manifest, null, 2));
+    console.log(`Vendored @imgly/background-removal ${BG_LIBRARY_VERSION}: ${chunks.size} data chunks`);
+}
+
+function walk(dir, out = []) {
+    for (const entry of fs.readdirSync(dir, { withFileTypes: true })) {
+        const full = path.join(dir, entry.name);
+        if (entry.isDirectory()) walk(full, out);
+        else out.push(full);
+    }
+    return out;
+}
+
+// server.js 가 Accept-Encoding 에 따라 고를 수 있도록 .br / .gz 를 옆에 만들어 둔다
+function precompress(dir) {
+    let count = 0;
+    for (const file of walk(dir)) {
+        if (COMPRESS_SKIP.has(path.extname(file).toLowerCase())) continue;
+        const raw = fs.readFileSync(file);
+        if (raw.length < COMPRESS_MIN_BYTES) continue;
+
+        const br = zlib.brotliCompressSync(raw, {
+            params: { [zlib.constants.BROTLI_PARAM_QUALITY]: 11, [zlib.constants.BROTLI_PARAM_SIZE_HINT]: raw.length },
+        });
+        const gz = zlib.gzipSync(raw, { level: 9 });
+        // 5% 이상 줄지 않으면 압축본을 두지 않는다 (모델 가중치 등)
+        if (br.length < raw.length * 0.95) fs.writeFileSync(file + '.br', br);
+        if (gz.length < raw.length * 0.95) fs.writeFileSync(file + '.gz', gz);
+        count++;
+    }
+    console.log(`Precompressed ${count} files`);
+}
+
+(async function main() {
+    if (process.env.SKIP_VENDOR) {
+        console.log('SKIP_VENDOR set: background-removal assets stay on the CDN');
+    } else {
+        try {
+            await vendorBackgroundRemoval();
+        } catch (e) {
+            // 네트워크가 없으면 CDN 로딩으로 동작한다
+            console.warn('Vendoring failed, falling back to CDN:', e.message);
+            fs.rmSync(VENDOR_DIR, { recursive: true, force: true });
+        }
+    }
+
+    if (process.env.SKIP_WASM) console.log('SKIP_WASM set: using existing public/wasm');
+    else buildWasm({ optional: true });
+
+    for (const file of walk(PUBLIC_DIR)) {
+        if (file.endsWith('.br') || file.endsWith('.gz')) fs.rmSync(file);
+    }
+    precompress(PUBLIC_DIR);
+
+    fs.rmSync('dist', { recursive: true, force: true });
+    fs.cpSync('public', 'dist', { recursive: true });
+    console.log('Build complete: public -> dist');
+})();
@@ -6,11 +6,44 @@ let hudImage = null;
 let imgX = 0, imgY = 0;
 let imgW = 0, imgH = 0;
 let imgScale = 1.0;
+let imgRotation = 0;   // 라디안, 시계 방향 +
 let isRunning = false;
 let currentFacing = 'environment';
 let lastCapturedBlob = null;
 let logoImage = null;
 
+// HUD 렌더링 방식
+//   'composite': HUD 이미지를 레이어에 한 번 래스터화하고 CSS transform 으로만 옮긴다 (GPU 합성)
+//   'canvas':    바뀔 때마다 overlayCanvas 에 다시 그린다 (?hud=canvas)
+const HUD_RENDER_MODE = new URLSearchParams(location.search).get('hud') === 'canvas' ? 'canvas' : 'composite';
+// 합성 레이어 텍스처 한 변의 최대 크기 (픽셀)
+const HUD_LAYER_MAX_SIZE = 4096;
+let hudLayer = null;
+let hudLayerScale = 1.0;
+let hudRasterTimer = 0;
+
+// HUD 이미지 밉 체인 (표시 크기 기준 1x, 0.5x, 0.25x). hudImage 는 1x 레벨을 가리킨다.
+const HUD_MIP_FACTORS = [1, 0.5, 0.25];
+let hudMips = [];
+let hudDetailMip = null;
+let hudDetailPending = false;
+let hudSourceBlob = null;
+let hudSourceSize = null;
+
+// 비디오 HUD: 소스 프레임마다 WebGL 로 다시 그려지는 캔버스를 HUD 이미지로 쓴다.
+//   ?live=camera | ?live=<URL>: 실시간 인물 컷아웃 (live-cutout.js)
+//   ?video=<URL> 또는 window.changeARVideo(): 크로마키 영상 (chroma-key.js)
+const LIVE_SOURCE = new URLSearchParams(location.search).get('live');
+const HUD_VIDEO_URL = new URLSearchParams(location.search).get('video');
+let videoHud = null;   // null | 'live' | 'chroma'
+
+// 렌더 상태: 바뀐 것이 있을 때만 다음 프레임에 다시 그린다
+// renderPending 이 VIDEO_FRAME_PENDING 이면 다음 카메라 프레임 콜백에서 그린다
+const VIDEO_FRAME_PENDING = -1;
+let renderPending = 0;
+let needsFullClear = true;
+let lastDrawnRect = null;
+
 // 제스처 상태
 const gesture = {
     isDragging: false,
@@ -23,85 +56,72 @@ const gesture = {
     pinchStartScale: 1.0,
 };
 
-// IndexedDB 헬퍼 함수
-function openImageDB() {
-    return new Promise((resolve, reject) => {
-        const request = indexedDB.open('ARImageDB', 1);
-        request.onerror = () => reject(request.error);
-        request.onsuccess = () => resolve(request.result);
-        request.onupgradeneeded = (e) => {
-            const db = e.target.result;
-            if (!db.objectStoreNames.contains('images')) {
-                db.createObjectStore('images', { keyPath: 'id' });
-            }
-        };
-    });
-}
-
-async function getImageFromDB() {
-    const db = await openImageDB();
-    return new Promise((resolve, reject) => {
-        const tx = db.transaction('images', 'readonly');
-        const store = tx.objectStore('images');
-        const request = store.get('arImage');
-        request.onsuccess = () => {
-            db.close();
-            if (request.result && request.result.blob) {
-                resolve(request.result.blob);
-            } else {
-                resolve(null);
-            }
-        };
-        request.onerror = () => {
-            db.close();
-            reject(request.error);
-        };
-    });
-}
-
 // === 초기화 ===
-async function init() {
-    console.log('[AR] 초기화 시작');
+// source: 시작 이미지 { blob, bitmap } (비디오 HUD 면 null)
+// decodedImage: start() 가 탭을 기다리는 동안 시작해 둔 decodeHudImage(source) 결과
+async function init(source, decodedImage) {
+    arStarting = true;
+    // 교차 출처 격리 여부 (server.js 의 COOP/COEP). SharedArrayBuffer / Wasm threads 를 쓸 수 있는지 결정한다.
+    // index.html 안에서도 실행되므로 index.js 의 CROSS_ORIGIN_ISOLATED 와 이름이 겹치지 않게 전역으로 두지 않는다.
+    console.log('[AR] 초기화 시작, crossOriginIsolated:', self.crossOriginIsolated === true);
     document.getElementById('loading-screen').classList.remove('hidden');
 
-    let imageBlob = null;
-    try {
-        imageBlob = await getImageFromDB();
-    } catch (e) {
-        console.error('[AR] IndexedDB 에러:', e);
-    }
-
-    if (!imageBlob) {
-        showError('이미지가 없습니다. 먼저 이미지를 업로드해주세요.');
-        return;
-    }
-
     try {
         updateLoading('카메라 연결 중...');
-        await initCamera();
+        // 카메라 연결(loadedmetadata 대기)과 이미지 디코드를 함께 기다린다
+        const [decoded] = await Promise.all([decodedImage, initCamera()]);
 
         updateLoading('캔버스 초기화...');
         initCanvas();
 
-        updateLoading('이미지 로딩...');
-        await loadImageFromBlob(imageBlob);
+        if (LIVE_SOURCE) {
+            updateLoading('실시간 컷아웃 준비 중...');
+            await loadLiveHud();
+        } else if (HUD_VIDEO_URL) {
+            updateLoading('영상 로딩...');
+            await loadChromaHud(HUD_VIDEO_URL);
+        } else if (decoded) {
+            installHudImage(decoded);
+        } else {
+            updateLoading('이미지 로딩...');
+            await loadImageElement(source.blob);
+        }
 
         initEvents();
 
+        initSceneAnchoring();
+
         logoImage = new Image();
+        logoImage.onload = sendLogoToCaptureWorker;
         logoImage.src = 'logo.png';
+        initCaptureFormat();
 
         hideLoading();
         showHint();
 
         isRunning = true;
-        animate();
+        startup.firstFramePending = true;
+        startFrameScheduler();
+        requestRender(true);
 
         console.log('[AR] 초기화 완료');
 
+        // 초기화 중에 업로드 화면으로 갔다 왔으면 그 사이 넘겨받은 이미지로 바꾸고,
+        // 아직 업로드 화면이면 보이지 않는 채로 돌지 않게 바로 멈춘다
+        const pending = startup.pendingHandoff;
+        startup.pendingHandoff = null;
+        if (pending) swapHudImage(pending);
+        if (typeof AppRouter !== 'undefined' && AppRouter.current() !== 'ar') suspendAR();
+
     } catch (error) {
         console.error('[AR] 초기화 실패:', error);
         showError('초기화 실패: ' + error.message);
+    } finally {
+        arStarting = false;
+        // 실패했으면 기다리던 이미지도 놓는다
+        const pending = startup.pendingHandoff;
+        startup.pendingHandoff = null;
+        if (pending && pending.bitmap) pending.bitmap.close();
     }
 }
 
@@ -120,19 +140,18 @@ async function initCamera() {
     video.setAttribute('playsinline', '');
     video.setAttribute('webkit-playsinline', '');
 
+    const t0 = performance.now();
+    let usedDefaultCamera = false;
     try {
         let stream;
         try {
             stream = await navigator.mediaDevices.getUserMedia({
-                video: {
-                    facingMode: 'environment',
-                    width: { ideal: 1280 },
-                    height: { ideal: 720 }
-                }
+                video: pickCameraConstraints('environment')
             });
         } catch (envErr) {
             console.warn('[AR] 후면 카메라 실패, 기본 카메라 시도:', envErr.message);
             stream = await navigator.mediaDevices.getUserMedia({ video: true });
+            usedDefaultCamera = true;
         }
 
         video.srcObject = stream;
@@ -166,8 +185,17 @@ async function initCamera() {
             await playPromise;
         }
         currentFacing = 'environment';
-
-        console.log('[AR] 카메라 연결됨:', video.videoWidth, 'x', video.videoHeight);
+        // 기본 카메라로 열었으면 어느 쪽인지 모르므로 기억하지 않는다
+        if (!usedDefaultCamera) rememberCameraDevice(currentFacing, stream);
+
+        await waitForFirstFrame(video);
+        // 해상도가 바뀔 때마다(카메라 전환, 캡처 해상도 변경, 회전) 좌표 변환을 다시 잡는다
+        video.addEventListener('resize', refreshViewport);
+        refreshViewport();
+        const firstFrameMs = performance.now() - t0;
+        FrameStats.record('cameraStart', firstFrameMs);
+        console.log('[AR] 카메라 연결됨:', video.videoWidth, 'x', video.videoHeight,
+            '첫 프레임까지', firstFrameMs.toFixed(0) + 'ms');
 
     } catch (e) {
         console.error('[AR] 카메라 에러:', e.name, e.message, e);
@@ -194,26 +222,103 @@ function initCanvas() {
     overlayCanvas.style.zIndex = '1';
     overlayCanvas.style.pointerEvents = 'none';
 
-    overlayCtx = overlayCanvas.getContext('2d');
     container.appendChild(overlayCanvas);
 
+    if (HUD_RENDER_MODE === 'composite') {
+        // overlayCanvas 는 크기 기준으로만 쓰고 컨텍스트를 만들지 않아 백버퍼를 잡지 않는다
+        hudLayer = document.createElement('canvas');
+        hudLayer.style.position = 'absolute';
+        hudLayer.style.top = '0';
+        hudLayer.style.left = '0';
+        hudLayer.style.zIndex = '2';
+        hudLayer.style.pointerEvents = 'none';
+        hudLayer.style.transformOrigin = '0 0';
+        hudLayer.style.willChange = 'transform';
+        hudLayer.style.visibility = 'hidden';
+        container.appendChild(hudLayer);
+    } else {
+        overlayCtx = overlayCanvas.getContext('2d');
+    }
+
     console.log('[AR] 캔버스 초기화 완료');
 }
 
 // === 이미지 로딩 ===
+// 화면 높이의 40%를 기본 크기로 두고 화면 가운데에 배치한다
+const HUD_INITIAL_HEIGHT_RATIO = 0.4;
+
+function placeHudImage(width, height) {
+    imgH = window.innerHeight * HUD_INITIAL_HEIGHT_RATIO;
+    imgW = imgH * (width / height);
+    imgX = window.innerWidth / 2;
+    imgY = window.innerHeight / 2;
+    imgScale = 1.0;
+    imgRotation = 0;
+}
+
+// 이미지를 한 번 디코드해서 표시 크기 기준 밉 체인을 만들고 원본 디코드는 바로 해제한다.
+// 화면 상태는 건드리지 않으므로 카메라/캔버스 준비 전에 미리 돌려 둘 수 있다.
+// source: { blob, bitmap } — bitmap 이 있으면(같은 문서에서 넘겨받음) 다시 디코드하지 않는다.
+// createImageBitmap 이 없으면 null (호출 측이 loadImageElement 로 처리한다).
+async function decodeHudImage(source) {
+    if (typeof createImageBitmap !== 'function') return null;
+
+    const t0 = performance.now();
+    const full = source.bitmap || await createImageBitmap(source.blob, { premultiplyAlpha: 'premultiply' });
+    const dpr = window.devicePixelRatio || 1;
+    const displayW = window.innerHeight * HUD_INITIAL_HEIGHT_RATIO * (full.width / full.height);
+    const baseW = Math.min(full.width, Math.round(displayW * dpr));
+    const baseH = Math.max(1, Math.round(baseW * full.height / full.width));
+    const size = { width: full.width, height: full.height };
+    let mips;
+    try {
+        mips = await Promise.all(HUD_MIP_FACTORS.map((f) => createImageBitmap(full, {
+            resizeWidth: Math.max(1, Math.round(baseW * f)),
+            resizeHeight: Math.max(1, Math.round(baseH * f)),
+            resizeQuality: 'high',
+            premultiplyAlpha: 'premultiply',
+        })));
+    } finally {
+        full.close();
+    }
+    FrameStats.record('startup.decode', performance.now() - t0);
+    return { blob: source.blob, size, mips };
+}
+
+function installHudImage(decoded) {
+    placeHudImage(decoded.size.width, decoded.size.height);
+    hudSourceBlob = decoded.blob;
+    hudSourceSize = decoded.size;
+    hudMips = decoded.mips;
+    hudImage = hudMips[0];
+    Resources.holdBlob('hudSource', decoded.blob);
+    Resources.release('hudMips');
+    hudMips.forEach((mip) => Resources.addBitmap('hudMips', mip));
+
+    rasterizeHudLayer();
+    requestRender();
+    console.log('[AR] 이미지 로딩 완료:', hudSourceSize.width, 'x', hudSourceSize.height,
+        '밉:', hudMips.map((m) => m.width + 'x' + m.height).join(', '));
+}
+
 async function loadImageFromBlob(blob) {
+    const decoded = await decodeHudImage({ blob, bitmap: null });
+    if (decoded) installHudImage(decoded);
+    else await loadImageElement(blob);
+}
+
+// createImageBitmap 미지원 브라우저용
+async function loadImageElement(blob) {
     const objectURL = URL.createObjectURL(blob);
     return new Promise((resolve, reject) => {
         const img = new Image();
         img.onload = () => {
             URL.revokeObjectURL(objectURL);
             hudImage = img;
-            // 화면 높이의 40%를 기본 크기로
-            imgH = window.innerHeight * 0.4;
-            imgW = imgH * (img.width / img.height);
-            imgX = window.innerWidth / 2;
-            imgY = window.innerHeight / 2;
-            imgScale = 1.0;
+            hudMips = [img];
+            placeHudImage(img.width, img.height);
+            rasterizeHudLayer();
+            requestRender();
             console.log('[AR] 이미지 로딩 완료:', img.width, 'x', img.height);
             resolve();
         };
@@ -225,6 +330,106 @@ async function loadImageFromBlob(blob) {
     });
 }
 
+// 매 프레임 그려지는 캔버스를 HUD 이미지로 쓴다. 합성 모드에서는 그 캔버스 자체가 합성 레이어가 된다.
+function installVideoHud(kind, canvas) {
+    if (videoHud === 'live' && kind !== 'live') stopLiveCutout();
+    if (videoHud === 'chroma' && kind !== 'chroma') stopChromaKey();
+    releaseHudMips();
+    videoHud = kind;
+    hudImage = canvas;
+    hudMips = [canvas];
+    if (imgW === 0) placeHudImage(canvas.width, canvas.height);
+    else imgW = imgH * (canvas.width / canvas.height);
+    if (hudLayer && hudLayer !== canvas) {
+        canvas.style.cssText = hudLayer.style.cssText;
+        hudLayer.replaceWith(canvas);
+        hudLayer = canvas;
+    }
+    rasterizeHudLayer();
+    requestRender();
+}
+
+// 소스가 바뀌어 캔버스 비율이 달라졌으면 높이를 유지하고 폭을 맞춘다
+function onVideoHudFrame() {
+    if (!hudImage) return;
+    const w = imgH * (hudImage.width / hudImage.height);
+    if (Math.abs(w - imgW) > 0.5) {
+        imgW = w;
+        rasterizeHudLayer();
+    }
+    requestRender();
+}
+
+// 정지 이미지 밉을 비디오 캔버스로 바꿀 때 해제한다
+function releaseHudMips() {
+    if (videoHud) return;
+    Resources.release('hudMips');
+    Resources.release('hudDetail');
+    Resources.release('hudSource');
+    hudMips = [];
+    hudDetailMip = null;
+    hudSourceBlob = null;
+    hudSourceSize = null;
+}
+
+async function loadLiveHud() {
+    const canvas = await startLiveCutout(LIVE_SOURCE, currentFacing, onVideoHudFrame);
+    installVideoHud('live', canvas);
+    window.addEventListener('pagehide', stopLiveCutout);
+}
+
+async function loadChromaHud(url, options) {
+    const canvas = await playChromaKeyVideo(url, options, onVideoHudFrame);
+    installVideoHud('chroma', canvas);
+    window.addEventListener('pagehide', stopChromaKey);
+}
+
+// 영상 변경 (README 의 window.changeARVideo). options: { keyColor: '#00ff00', similarity, smoothness, spill }
+window.changeARVideo = function(url, options) {
+    if (!isRunning) return Promise.reject(new Error('AR 이 시작되지 않았습니다'));
+    return loadChromaHud(url, options).catch((e) => {
+        console.error('[AR] 영상 변경 실패:', e);
+        showToast('영상을 불러올 수 없습니다');
+        throw e;
+    });
+};
+
+// 그릴 픽셀 폭에 가장 가까운(그보다 작지 않은) 밉을 고른다.
+// 확대해서 가장 큰 밉보다 커지면 그 크기로 한 단계를 비동기로 더 디코드해 둔다.
+function pickHudMip(targetWidth) {
+    const levels = hudDetailMip ? [hudDetailMip, ...hudMips] : hudMips;
+    let best = levels[0];
+    for (const mip of levels) {
+        if (mip.width >= targetWidth * 0.9) best = mip;
+    }
+    if (targetWidth > levels[0].width * 1.1) decodeHudDetail(targetWidth);
+    return best;
+}
+
+async function decodeHudDetail(targetWidth) {
+    if (hudDetailPending || !hudSourceBlob || !hudSourceSize) return;
+    const width = Math.min(hudSourceSize.width, HUD_LAYER_MAX_SIZE, Math.round(targetWidth));
+    const current = hudDetailMip || hudMips[0];
+    if (width <= current.width * 1.1) return;
+
+    hudDetailPending = true;
+    try {
+        const mip = await createImageBitmap(hudSourceBlob, {
+            resizeWidth: width,
+            resizeHeight: Math.max(1, Math.round(width * hudSourceSize.height / hudSourceSize.width)),
+            resizeQuality: 'high',
+            premultiplyAlpha: 'premultiply',
+        });
+        hudDetailMip = Resources.holdBitmap('hudDetail', mip);
+        rasterizeHudLayer();
+        requestRender(true);
+    } catch (e) {
+        console.warn('[AR] 고해상도 밉 디코드 실패:', e);
+    } finally {
+        hudDetailPending = false;
+    }
+}
+
 // === 이벤트 설정 ===
 function initEvents() {
     const touchArea = document.getElementById('touch-area');
@@ -255,13 +460,16 @@ function initEvents() {
         if (gesture.isDragging && e.touches.length === 1) {
             imgX = gesture.objStartX + (e.touches[0].clientX - gesture.dragStartX);
             imgY = gesture.objStartY + (e.touches[0].clientY - gesture.dragStartY);
+            requestRender();
         } else if (gesture.isPinching && e.touches.length === 2) {
             const ratio = getTouchDistance(e.touches) / gesture.pinchStartDist;
             imgScale = Math.max(0.3, Math.min(5.0, gesture.pinchStartScale * ratio));
+            requestRender();
         }
     }, { passive: false });
 
     touchArea.addEventListener('touchend', (e) => {
+        if (gesture.isPinching) scheduleHudRaster(0);
         if (e.touches.length === 0) {
             gesture.isDragging = false;
             gesture.isPinching = false;
@@ -289,6 +497,7 @@ function initEvents() {
         if (!mouseDown || !hudImage) return;
         imgX = gesture.objStartX + (e.clientX - gesture.dragStartX);
         imgY = gesture.objStartY + (e.clientY - gesture.dragStartY);
+        requestRender();
     });
 
     touchArea.addEventListener('mouseup', () => { mouseDown = false; });
@@ -299,25 +508,27 @@ function initEvents() {
         e.preventDefault();
         const delta = e.deltaY > 0 ? 0.9 : 1.1;
         imgScale = Math.max(0.3, Math.min(5.0, imgScale * delta));
+        requestRender();
+        scheduleHudRaster(150);
     }, { passive: false });
 
-    document.getElementById('btn-back').addEventListener('click', () => {
-        window.location.href = 'index.html';
-    });
+    document.getElementById('btn-back').addEventListener('click', leaveAR);
 
     document.getElementById('btn-switch-camera').addEventListener('click', switchCamera);
 
-    document.getElementById('btn-new-image').addEventListener('click', () => {
-        window.location.href = 'index.html';
-    });
+    document.getElementById('btn-new-image').addEventListener('click', leaveAR);
 
-    document.getElementById('btn-capture').addEventListener('click', captureScreen);
+    initCaptureButton();
     document.getElementById('btn-download').addEventListener('click', downloadCapture);
 
     document.getElementById('hint-overlay').addEventListener('click', () => {
         document.getElementById('hint-overlay').classList.remove('visible');
+        prewarmOtherCamera();
     });
 
+    window.addEventListener('pagehide', releaseParkedStreams);
+    window.addEventListener('pagehide', releaseBurstSlots);
+
     window.addEventListener('resize', onResize);
 
     console.log('[AR] 이벤트 설정 완료');
@@ -331,34 +542,364 @@ function getTouchDistance(touches) {
 }
 
 // === 카메라 전환 ===
-async function switchCamera() {
-    currentFacing = currentFacing === 'environment' ? 'user' : 'environment';
+// 'warm': 새 스트림을 먼저 열고 srcObject 를 한 번에 바꾼다. 이전 스트림은 잠시 열어 두었다가 닫는다.
+// 'cold': 모든 트랙을 멈춘 뒤 getUserMedia 를 다시 호출한다 (?camera=cold, 비교용)
+const CAMERA_SWITCH_MODE = new URLSearchParams(location.search).get('camera') === 'cold' ? 'cold' : 'warm';
+const CAMERA_SWITCH_OPTIONS = {
+    // 전환 후 이전 스트림을 열어 두는 시간
+    warmGraceMs: 10000,
+    // 안내 오버레이를 닫을 때 반대쪽 카메라를 미리 연다.
+    // 카메라를 하나만 열 수 있는 기기(iOS 등)에서는 현재 트랙이 mute 되므로 기본은 끈다.
+    prewarm: false,
+};
+
+const parkedStreams = new Map();   // facing -> { stream, timer }
+const cameraDeviceIds = new Map(); // facing -> deviceId
+let cameraListPromise = null;
+let cameraSwitching = false;
+
+function otherFacing(facing) {
+    return facing === 'environment' ? 'user' : 'environment';
+}
+
+// 비디오 입력 장치 목록 (한 번만 조회)
+function listCameras() {
+    if (!cameraListPromise) {
+        cameraListPromise = navigator.mediaDevices.enumerateDevices
+            ? navigator.mediaDevices.enumerateDevices()
+                .then((devices) => devices.filter((d) => d.kind === 'videoinput'))
+                .catch(() => [])
+            : Promise.resolve([]);
+    }
+    return cameraListPromise;
+}
+
+function stopStream(stream) {
+    if (stream) stream.getTracks().forEach((t) => t.stop());
+}
 
+function isStreamLive(stream) {
+    const tracks = stream ? stream.getVideoTracks() : [];
+    return tracks.length > 0 && tracks.every((t) => t.readyState === 'live' && !t.muted);
+}
+
+// 다음에 같은 카메라를 열 때 facingMode 해석 없이 deviceId 로 바로 열 수 있게 기억해 둔다
+function rememberCameraDevice(facing, stream) {
+    const track = stream.getVideoTracks()[0];
+    const settings = track && track.getSettings ? track.getSettings() : {};
+    if (settings.deviceId) cameraDeviceIds.set(settings.facingMode || facing, settings.deviceId);
+}
+
+async function openCameraStream(facing) {
+    const parked = parkedStreams.get(facing);
+    if (parked) {
+        clearTimeout(parked.timer);
+        parkedStreams.delete(facing);
+        if (isStreamLive(parked.stream)) return { stream: parked.stream, warm: true };
+        stopStream(parked.stream);
+    }
+
+    const constraints = pickCameraConstraints(facing);
+    const deviceId = cameraDeviceIds.get(facing);
+    let stream = null;
+    if (deviceId) {
+        const { facingMode, ...rest } = constraints;
+        try {
+            stream = await navigator.mediaDevices.getUserMedia({ video: { ...rest, deviceId: { exact: deviceId } } });
+        } catch (e) {
+            cameraDeviceIds.delete(facing);
+        }
+    }
+    if (!stream) stream = await navigator.mediaDevices.getUserMedia({ video: constraints });
+    rememberCameraDevice(facing, stream);
+    return { stream, warm: false };
+}
+
+// 쓰지 않는 스트림을 잠시 열어 두었다가 닫는다
+function parkCameraStream(facing, stream) {
+    const prev = parkedStreams.get(facing);
+    if (prev) {
+        clearTimeout(prev.timer);
+        if (prev.stream !== stream) stopStream(prev.stream);
+    }
+    const timer = setTimeout(() => {
+        parkedStreams.delete(facing);
+        stopStream(stream);
+    }, CAMERA_SWITCH_OPTIONS.warmGraceMs);
+    parkedStreams.set(facing, { stream, timer });
+}
+
+function releaseParkedStreams() {
+    parkedStreams.forEach(({ stream, timer }) => {
+        clearTimeout(timer);
+        stopStream(stream);
+    });
+    parkedStreams.clear();
+}
+
+async function prewarmOtherCamera() {
+    if (CAMERA_SWITCH_MODE !== 'warm' || !CAMERA_SWITCH_OPTIONS.prewarm || cameraSwitching) return;
+    const facing = otherFacing(currentFacing);
+    if (parkedStreams.has(facing) || (await listCameras()).length < 2) return;
     try {
-        if (video.srcObject) {
-            video.srcObject.getTracks().forEach(t => t.stop());
+        const { stream } = await openCameraStream(facing);
+        // 현재 카메라가 끊기면 미리 열기를 포기한다
+        if (!isStreamLive(video.srcObject)) {
+            stopStream(stream);
+            console.warn('[AR] 카메라 미리 열기가 현재 스트림을 중단시켜 취소');
+            return;
+        }
+        parkCameraStream(facing, stream);
+        console.log('[AR] 카메라 미리 열기:', facing);
+    } catch (e) {
+        console.warn('[AR] 카메라 미리 열기 실패:', e);
+    }
+}
+
+// 새 스트림의 첫 프레임이 화면에 표시될 때까지 기다린다
+function waitForFirstFrame(videoEl, timeoutMs = 3000) {
+    return new Promise((resolve) => {
+        const tid = setTimeout(resolve, timeoutMs);
+        const done = () => {
+            clearTimeout(tid);
+            resolve();
+        };
+        if (typeof videoEl.requestVideoFrameCallback === 'function') {
+            videoEl.requestVideoFrameCallback(done);
+        } else if (videoEl.readyState >= 2) {
+            done();
+        } else {
+            videoEl.addEventListener('loadeddata', done, { once: true });
         }
+    });
+}
+
+async function switchCamera() {
+    if (cameraSwitching) return;
+    cameraSwitching = true;
+
+    const from = currentFacing;
+    const to = otherFacing(from);
+    const t0 = performance.now();
+    let warm = false;
 
-        const stream = await navigator.mediaDevices.getUserMedia({
-            video: {
-                facingMode: currentFacing,
-                width: { ideal: 1280 },
-                height: { ideal: 720 }
+    try {
+        if (CAMERA_SWITCH_MODE === 'cold') {
+            stopStream(video.srcObject);
+            video.srcObject = await navigator.mediaDevices.getUserMedia({ video: pickCameraConstraints(to) });
+        } else {
+            let prev = video.srcObject;
+            let opened;
+            try {
+                opened = await openCameraStream(to);
+            } catch (e) {
+                // 카메라를 동시에 둘 열 수 없는 기기: 이전 스트림을 닫고 다시 연다
+                if (!prev) throw e;
+                stopStream(prev);
+                prev = null;
+                opened = await openCameraStream(to);
             }
-        });
+            warm = opened.warm;
+            video.srcObject = opened.stream;
+            if (prev) parkCameraStream(from, prev);
+        }
+        currentFacing = to;
 
-        video.srcObject = stream;
-        video.classList.toggle('mirror', currentFacing === 'user');
         await video.play();
+        await waitForFirstFrame(video);
+        // 이전 카메라의 마지막 프레임이 뒤집혀 보이지 않도록 첫 프레임 이후에 반전한다
+        video.classList.toggle('mirror', to === 'user');
+        refreshViewport();
 
-        console.log('카메라 전환:', currentFacing);
+        const firstFrameMs = performance.now() - t0;
+        FrameStats.record('cameraSwitch.' + CAMERA_SWITCH_MODE, firstFrameMs);
+        console.log('[AR] 카메라 전환:', to, `(${CAMERA_SWITCH_MODE}${warm ? ', 재사용' : ''})`,
+            '첫 프레임까지', firstFrameMs.toFixed(0) + 'ms');
 
     } catch (e) {
-        console.error('카메라 전환 실패:', e);
+        console.error('[AR] 카메라 전환 실패:', e);
+        if (!isStreamLive(video.srcObject)) {
+            try {
+                video.srcObject = (await openCameraStream(from)).stream;
+                await video.play();
+            } catch (restoreErr) {
+                console.error('[AR] 이전 카메라 복구 실패:', restoreErr);
+            }
+        }
+    } finally {
+        cameraSwitching = false;
     }
 }
 
 // === 화면 캡처 ===
+// 선호 순. 네이티브 갤러리가 받고(bridge.js SAVE_OPTIONS.galleryImageTypes) 캔버스가 만들 수 있는 첫 형식을 쓴다.
+const CAPTURE_FORMATS = [
+    { type: 'image/avif', quality: 0.7 },
+    { type: 'image/webp', quality: 0.85 },
+    { type: 'image/jpeg', quality: 0.85 },
+];
+let captureFormat = CAPTURE_FORMATS[CAPTURE_FORMATS.length - 1];
+
+function initCaptureFormat() {
+    ImageEncoder.pickFormat(CAPTURE_FORMATS, _galleryAcceptsImage).then((format) => {
+        captureFormat = format;
+        console.log('[AR] 캡처 형식:', format.type, format.quality);
+    });
+}
+
+let captureWorker = null;
+let captureLogoBitmap = null;   // 워커에 복사해 넘기는 로고 원본
+const captureJobs = new Map();
+let captureJobSeq = 0;
+
+function canUseCaptureWorker() {
+    return typeof Worker !== 'undefined' &&
+        typeof OffscreenCanvas !== 'undefined' &&
+        typeof OffscreenCanvas.prototype.convertToBlob === 'function' &&
+        typeof createImageBitmap === 'function';
+}
+
+function getCaptureWorker() {
+    if (captureWorker) return captureWorker;
+    captureWorker = new Worker('capture-worker.js');
+    captureWorker.onmessage = (e) => {
+        const msg = e.data;
+        const job = captureJobs.get(msg.id);
+        if (!job) return;
+        captureJobs.delete(msg.id);
+        if (msg.type === 'done') job.resolve(msg.blob);
+        else job.reject(new Error(msg.message));
+    };
+    captureWorker.onerror = (e) => {
+        console.error('[AR] 캡처 워커 오류:', e.message);
+        captureJobs.forEach((job) => job.reject(new Error(e.message || 'worker_error')));
+        captureJobs.clear();
+        captureWorker = null;
+    };
+    // 오류 뒤 새로 만든 워커도 로고를 받아야 글자 워터마크로 바뀌지 않는다 (캡처 요청보다 먼저 보낸다)
+    if (captureLogoBitmap) captureWorker.postMessage({ type: 'logo', bitmap: captureLogoBitmap });
+    return captureWorker;
+}
+
+// 로고는 한 번만 ImageBitmap 으로 만들어 두고, 워커를 만들 때마다 복사본을 넘긴다
+function sendLogoToCaptureWorker() {
+    if (!canUseCaptureWorker() || !logoImage || !logoImage.naturalWidth) return;
+    createImageBitmap(logoImage).then((bitmap) => {
+        captureLogoBitmap = bitmap;
+        Resources.release('captureLogo');
+        Resources.addBitmap('captureLogo', bitmap);
+        if (captureWorker) captureWorker.postMessage({ type: 'logo', bitmap });
+        else getCaptureWorker();
+    }).catch((e) => console.warn('[AR] 로고 비트맵 생성 실패:', e));
+}
+
+// 현재 카메라 프레임을 가져온다.
+// MediaStreamTrackProcessor(VideoFrame) -> ImageCapture.grabFrame -> video 요소 순으로 시도한다.
+async function grabCameraFrame() {
+    const track = video.srcObject && video.srcObject.getVideoTracks()[0];
+    if (track && typeof MediaStreamTrackProcessor === 'function' && typeof VideoFrame === 'function') {
+        // 미리보기 트랙의 프레임 큐를 건드리지 않도록 복제 트랙에서 한 장만 읽는다
+        const clone = track.clone();
+        try {
+            const reader = new MediaStreamTrackProcessor({ track: clone }).readable.getReader();
+            const { value } = await reader.read();
+            reader.cancel();
+            if (value) return value;
+        } catch (e) {
+            console.warn('[AR] VideoFrame 캡처 실패:', e);
+        } finally {
+            clone.stop();
+        }
+    }
+    if (track && typeof ImageCapture === 'function') {
+        try {
+            return await new ImageCapture(track).grabFrame();
+        } catch (e) {
+            console.warn('[AR] ImageCapture.grabFrame 실패:', e);
+        }
+    }
+    return createImageBitmap(video);
+}
+
+// 캡처 합성 레이아웃 (capture-compose.js 참고)
+function captureLayout(width, height) {
+    const scale = width / window.innerWidth;
+    const hud = hudImage ? hudBounds(scale) : null;
+
+    let logo = null;
+    if (logoImage && logoImage.complete && logoImage.naturalWidth > 0) {
+        const logoAspect = logoImage.naturalWidth / logoImage.naturalHeight;
+        const lWidth = Math.min(width, height) * 0.20;
+        const lHeight = lWidth / logoAspect;
+        const lMargin = 30;
+        logo = { x: width - lWidth - lMargin, y: height - lHeight - lMargin, w: lWidth, h: lHeight };
+    }
+
+    return {
+        width,
+        height,
+        // 출력은 화면과 비율이 같으므로 미리보기와 같은 소스 영역을 그대로 쓴다 (viewport.js)
+        videoSize: { width: viewport.videoWidth, height: viewport.videoHeight },
+        video: viewport.source,
+        mirror: viewport.mirror,
+        // 화면 레이어를 복사하지 않고 원본 이미지를 같은 위치에 그려서 두 렌더 모드의 결과를 같게 한다
+        hud: hud && { x: hud.drawX, y: hud.drawY, w: hud.drawW, h: hud.drawH, rotation: hud.rotation },
+        logo,
+    };
+}
+
+async function captureInWorker(layout) {
+    const frame = await grabCameraFrame();
+    let hud = null;
+    try {
+        // 밉 자체를 넘기면 분리되므로 GPU 복사본을 만들어 넘긴다
+        if (layout.hud) hud = await createImageBitmap(pickHudMip(layout.hud.w));
+    } catch (e) {
+        frame.close();
+        throw e;
+    }
+    const transfer = hud ? [frame, hud] : [frame];
+    return new Promise((resolve, reject) => {
+        const id = ++captureJobSeq;
+        captureJobs.set(id, { resolve, reject });
+        getCaptureWorker().postMessage({
+            type: 'capture', id, layout, frame, hud, mimeType: captureFormat.type, quality: captureFormat.quality,
+        }, transfer);
+    });
+}
+
+function captureOnMainThread(layout) {
+    const canvas = document.createElement('canvas');
+    canvas.width = layout.width;
+    canvas.height = layout.height;
+    const hud = layout.hud ? pickHudMip(layout.hud.w) : null;
+    composeCapture(canvas.getContext('2d'), layout, video, hud, layout.logo ? logoImage : null);
+    return ImageEncoder.encode(canvas, captureFormat.type, captureFormat.quality, 'capture');
+}
+
+// 미리보기 해상도가 캡처 출력보다 낮으면 캡처하는 동안만 트랙 해상도를 올린다.
+// 스트림은 그대로 두고 applyConstraints 로 올렸다가 끝나면 미리보기 제약으로 되돌린다.
+async function withCaptureResolution(fn) {
+    const track = video.srcObject && video.srcObject.getVideoTracks()[0];
+    if (!track || !track.applyConstraints || !viewport.videoWidth || viewport.source.sw >= overlayCanvas.width) return fn();
+
+    let boosted = false;
+    try {
+        await applyCameraConstraints(video, track, pickCameraConstraints(currentFacing, 'capture', track));
+        boosted = true;
+    } catch (e) {
+        console.warn('[AR] 캡처 해상도 변경 실패, 현재 해상도로 캡처:', e);
+    }
+    try {
+        return await fn();
+    } finally {
+        if (boosted) {
+            applyCameraConstraints(video, track, pickCameraConstraints(currentFacing, 'preview'))
+                .catch((e) => console.warn('[AR] 미리보기 해상도 복원 실패:', e));
+        }
+    }
+}
+
 async function captureScreen() {
     console.log('[AR] captureScreen 호출됨');
     if (!video || !overlayCanvas) {
@@ -373,84 +914,197 @@ async function captureScreen() {
 
         showToast('캡처 중... 잠시만 기다려주세요');
 
-        const canvas = document.createElement('canvas');
-        canvas.width = overlayCanvas.width;
-        canvas.height = overlayCanvas.height;
-        const ctx = canvas.getContext('2d');
-
-        const isMirrored = currentFacing === 'user';
-        drawVideoCover(ctx, video, canvas.width, canvas.height, isMirrored);
+        const t0 = performance.now();
+        const blob = await withCaptureResolution(async () => {
+            const layout = captureLayout(overlayCanvas.width, overlayCanvas.height);
+            if (canUseCaptureWorker()) {
+                try {
+                    return await captureInWorker(layout);
+                } catch (e) {
+                    console.warn('[AR] 워커 캡처 실패, 메인 스레드로 재시도:', e);
+                }
+            }
+            return captureOnMainThread(layout);
+        });
 
-        ctx.drawImage(overlayCanvas, 0, 0);
+        if (blob) {
+            lastCapturedBlob = Resources.holdBlob('capture', blob);
+            const latency = performance.now() - t0;
+            FrameStats.record('captureLatency', latency);
+            console.log('[AR] 캡처 Blob 크기:', (blob.size / 1024).toFixed(0) + 'KB', latency.toFixed(0) + 'ms');
 
-        if (logoImage && logoImage.complete && logoImage.naturalWidth > 0) {
-            const logoAspect = logoImage.naturalWidth / logoImage.naturalHeight;
-            const lWidth = Math.min(canvas.width, canvas.height) * 0.20;
-            const lHeight = lWidth / logoAspect;
-            const lMargin = 30;
-            const lx = canvas.width - lWidth - lMargin;
-            const ly = canvas.height - lHeight - lMargin;
+            const downloadBtn = document.getElementById('btn-download');
+            downloadBtn.style.opacity = '1';
+            downloadBtn.style.pointerEvents = 'auto';
 
-            ctx.save();
-            ctx.globalAlpha = 0.6;
-            ctx.drawImage(logoImage, lx, ly, lWidth, lHeight);
-            ctx.restore();
+            showToast('촬영 완료! 저장 버튼을 누르세요.');
         } else {
-            ctx.fillStyle = 'rgba(255, 255, 255, 0.7)';
-            ctx.font = 'bold 30px sans-serif';
-            ctx.fillText('LOGO', canvas.width - 150, canvas.height - 50);
+            showToast('캡처 실패 (Canvas 오류)');
         }
 
-        canvas.toBlob((blob) => {
-            if (blob) {
-                lastCapturedBlob = blob;
-                console.log('[AR] 캡처 Blob 크기:', (blob.size / 1024).toFixed(0) + 'KB');
-
-                const downloadBtn = document.getElementById('btn-download');
-                downloadBtn.style.opacity = '1';
-                downloadBtn.style.pointerEvents = 'auto';
-
-                showToast('촬영 완료! 저장 버튼을 누르세요.');
-            } else {
-                showToast('캡처 실패 (Canvas 오류)');
-            }
-        }, 'image/jpeg', 0.85);
-
     } catch (err) {
         console.error('[AR] 캡처 중 치명적 오류:', err);
         alert('캡처 중 오류가 발생했습니다: ' + err.message);
     }
 }
 
-function drawVideoCover(ctx, video, canvasWidth, canvasHeight, mirror = false) {
-    const videoWidth = video.videoWidth;
-    const videoHeight = video.videoHeight;
-    if (videoWidth === 0 || videoHeight === 0) return;
+// === 캡처 버튼 ===
+// 사진 모드: 누르면 한 장, 길게 누르고 있으면 연속 촬영 (burst-capture.js)
+// 영상 모드(상단 버튼으로 전환): 누르면 녹화 시작/정지 (video-recorder.js)
+const CAPTURE_LONG_PRESS_MS = 400;
+let captureMode = 'photo';   // 'photo' | 'video'
+
+function initCaptureButton() {
+    const btn = document.getElementById('btn-capture');
+    let pressTimer = 0;
+    let longPressed = false;
+    btn.addEventListener('pointerdown', () => {
+        longPressed = false;
+        if (captureMode !== 'photo') return;
+        pressTimer = setTimeout(() => {
+            longPressed = true;
+            startBurstCapture();
+        }, CAPTURE_LONG_PRESS_MS);
+    });
+    // 최대 장수에 닿아 먼저 멈췄어도 손을 떼면 고르기 화면을 연다
+    const release = () => {
+        clearTimeout(pressTimer);
+        if (burstPending) finishBurstCapture();
+    };
+    ['pointerup', 'pointerleave', 'pointercancel'].forEach((type) => btn.addEventListener(type, release));
+    btn.addEventListener('click', () => {
+        if (longPressed) {
+            longPressed = false;
+            return;
+        }
+        if (captureMode === 'video') {
+            if (isVideoRecording()) stopRecording();
+            else startRecording();
+        } else {
+            captureScreen();
+        }
+    });
+
+    document.getElementById('btn-capture-mode').addEventListener('click', () => {
+        if (isVideoRecording()) return;
+        captureMode = captureMode === 'photo' ? 'video' : 'photo';
+        btn.classList.toggle('video-mode', captureMode === 'video');
+        document.getElementById('btn-capture-mode').classList.toggle('active', captureMode === 'video');
+        showToast(captureMode === 'video' ? '영상 모드: 촬영 버튼으로 녹화' : '사진 모드');
+    });
+}
 
-    const videoRatio = videoWidth / videoHeight;
-    const canvasRatio = canvasWidth / canvasHeight;
+// === 연속 촬영 ===
+// 슬롯에는 사진 캡처와 같은 합성을 그린다. 인코딩은 캡처 워커(없으면 toBlob)에서 한 장씩 한다.
+function encodeBurstSlot(canvas, release) {
+    if (!canUseCaptureWorker()) {
+        return ImageEncoder.encode(canvas, captureFormat.type, captureFormat.quality, 'burst');
+    }
+    return createImageBitmap(canvas).then((bitmap) => {
+        release();
+        return new Promise((resolve, reject) => {
+            const id = ++captureJobSeq;
+            captureJobs.set(id, { resolve, reject });
+            getCaptureWorker().postMessage({
+                type: 'encode', id, bitmap, mimeType: captureFormat.type, quality: captureFormat.quality,
+            }, [bitmap]);
+        });
+    });
+}
 
-    let sx, sy, sWidth, sHeight;
+let burstPending = false;
 
-    if (videoRatio > canvasRatio) {
-        sHeight = videoHeight;
-        sWidth = videoHeight * canvasRatio;
-        sx = (videoWidth - sWidth) / 2;
-        sy = 0;
-    } else {
-        sWidth = videoWidth;
-        sHeight = videoWidth / canvasRatio;
-        sx = 0;
-        sy = (videoHeight - sHeight) / 2;
+function startBurstCapture() {
+    if (!video || !video.videoWidth || isVideoRecording()) return;
+    startBurst(overlayCanvas.width, overlayCanvas.height, drawRecordFrame, encodeBurstSlot);
+    burstPending = true;
+    document.getElementById('btn-capture').classList.add('burst');
+}
+
+async function finishBurstCapture() {
+    burstPending = false;
+    document.getElementById('btn-capture').classList.remove('burst');
+    showToast('연속 촬영 정리 중...');
+    const blobs = await finishBurst();
+    if (blobs.length === 0) {
+        showToast('연속 촬영 실패');
+        return;
     }
+    showBurstPicker(blobs);
+}
 
-    if (mirror) {
-        ctx.save();
-        ctx.scale(-1, 1);
-        ctx.drawImage(video, sx, sy, sWidth, sHeight, -canvasWidth, 0, canvasWidth, canvasHeight);
-        ctx.restore();
-    } else {
-        ctx.drawImage(video, sx, sy, sWidth, sHeight, 0, 0, canvasWidth, canvasHeight);
+// 찍힌 장 중 하나를 골라 저장 대상으로 삼는다
+function showBurstPicker(blobs) {
+    const picker = document.getElementById('burst-picker');
+    const strip = document.getElementById('burst-strip');
+    const urls = blobs.map((blob) => Resources.addObjectURL('burstPicker', blob));
+    let chosen = blobs.length - 1;
+
+    const close = () => {
+        picker.classList.remove('visible');
+        strip.textContent = '';
+        Resources.release('burstPicker');
+    };
+    const select = (index) => {
+        chosen = index;
+        strip.querySelectorAll('img').forEach((img, i) => img.classList.toggle('selected', i === index));
+    };
+
+    strip.textContent = '';
+    urls.forEach((url, i) => {
+        const img = document.createElement('img');
+        img.src = url;
+        img.decoding = 'async';
+        img.addEventListener('click', () => select(i));
+        strip.appendChild(img);
+    });
+    select(chosen);
+
+    document.getElementById('burst-use').onclick = () => {
+        lastCapturedBlob = Resources.holdBlob('capture', blobs[chosen]);
+        const downloadBtn = document.getElementById('btn-download');
+        downloadBtn.style.opacity = '1';
+        downloadBtn.style.pointerEvents = 'auto';
+        close();
+        showToast((chosen + 1) + '번째 사진을 골랐습니다. 저장 버튼을 누르세요.');
+    };
+    document.getElementById('burst-cancel').onclick = close;
+    picker.classList.add('visible');
+}
+
+// === 녹화 ===
+// 녹화 프레임 / 연속 촬영 슬롯에 한 장을 합성한다. 사진 캡처와 같은 레이아웃/합성 함수를 쓴다.
+function drawRecordFrame(ctx, width, height) {
+    const layout = captureLayout(width, height);
+    const hud = layout.hud ? pickHudMip(layout.hud.w) : null;
+    composeCapture(ctx, layout, video, hud, layout.logo ? logoImage : null);
+}
+
+async function startRecording() {
+    if (!video || !video.videoWidth) return;
+    try {
+        await startVideoRecording(window.innerWidth, window.innerHeight, drawRecordFrame, stopRecording);
+        document.getElementById('btn-capture').classList.add('recording');
+        showToast('녹화 중... 버튼을 누르면 멈춥니다');
+    } catch (e) {
+        console.error('[AR] 녹화 시작 실패:', e);
+        showToast('녹화를 시작할 수 없습니다');
+    }
+}
+
+async function stopRecording() {
+    if (!isVideoRecording()) return;
+    document.getElementById('btn-capture').classList.remove('recording');
+    showToast('영상 저장 중...');
+    try {
+        const summary = await stopVideoRecording();
+        showToast(summary && summary.partial
+            ? '녹화가 중간에 멈춰 그때까지의 영상만 저장되었습니다'
+            : '영상이 갤러리에 저장되었습니다');
+    } catch (e) {
+        const errMsg = e && e.message ? e.message : String(e);
+        console.error('[AR] 영상 저장 실패:', errMsg);
+        showToast('영상 저장 실패: ' + errMsg);
     }
 }
 
@@ -465,6 +1119,12 @@ async function downloadCapture() {
 
     try {
         await _saveToGallery(lastCapturedBlob);
+        // 저장했으면 더 붙잡고 있을 이유가 없다
+        lastCapturedBlob = null;
+        Resources.release('capture');
+        const downloadBtn = document.getElementById('btn-download');
+        downloadBtn.style.opacity = '';
+        downloadBtn.style.pointerEvents = '';
         showToast('갤러리에 저장되었습니다');
     } catch (err) {
         var errMsg = err && err.message ? err.message : String(err);
@@ -480,6 +1140,20 @@ function onResize() {
     overlayCanvas.height = window.innerHeight * dpr;
     overlayCanvas.style.width = window.innerWidth + 'px';
     overlayCanvas.style.height = window.innerHeight + 'px';
+    refreshViewport();
+    // 캔버스 크기를 바꾸면 내용이 지워지므로 전체를 다시 그린다
+    lastDrawnRect = null;
+    rasterizeHudLayer();
+    requestRender(true);
+}
+
+// 화면/비디오 크기나 카메라 방향이 바뀌면 좌표 변환을 다시 계산하고 비디오 요소를 다시 배치한다
+function refreshViewport() {
+    if (!video) return;
+    const mirror = currentFacing === 'user';
+    if (updateViewport(video.videoWidth, video.videoHeight, window.innerWidth, window.innerHeight, mirror)) {
+        applyViewportToVideo(video);
+    }
 }
 
 // === UI 함수 ===
@@ -493,7 +1167,7 @@ function hideLoading() {
 
 function showError(message) {
     document.getElementById('loading-screen').classList.add('hidden');
-    document.getElementById('error-message').textContent = message;
+    document.getElementById('ar-error-message').textContent = message;
     document.getElementById('error-screen').classList.add('visible');
 }
 
@@ -511,36 +1185,511 @@ function showToast(message) {
 }
 
 // === 렌더 루프 ===
+// 제스처/리사이즈/이미지 로딩이 requestRender() 로 무효화하면 다음 rAF 에서 한 번만 그린다.
+// 아무것도 바뀌지 않으면 rAF 를 걸지 않으므로 루프가 완전히 쉰다.
+function requestRender(fullClear = false) {
+    if (fullClear) needsFullClear = true;
+    if (renderPending || !isRunning) return;
+    if (videoFramesFlowing()) {
+        renderPending = VIDEO_FRAME_PENDING;
+        // 카메라 프레임이 끊겨도 갱신이 멈추지 않게 한다
+        setTimeout(() => { if (renderPending === VIDEO_FRAME_PENDING) animate(); }, VIDEO_FRAME_STALL_MS);
+    } else {
+        renderPending = requestAnimationFrame(animate);
+    }
+}
+
+// === 프레임 스케줄러 ===
+// requestVideoFrameCallback 으로 카메라 프레임마다 통계를 쌓고, 대기 중인 HUD 갱신을 같은 프레임에 반영한다.
+const VIDEO_FRAME_STALL_MS = 100;
+let lastVideoFrame = null;
+let lastVideoFrameAt = 0;
+
+function videoFramesFlowing() {
+    return lastVideoFrameAt > 0 && performance.now() - lastVideoFrameAt < VIDEO_FRAME_STALL_MS;
+}
+
+function startFrameScheduler() {
+    if (!video || typeof video.requestVideoFrameCallback !== 'function') {
+        console.log('[AR] requestVideoFrameCallback 미지원: rAF 로 렌더링');
+        return;
+    }
+    video.requestVideoFrameCallback(onVideoFrame);
+}
+
+function onVideoFrame(now, metadata) {
+    video.requestVideoFrameCallback(onVideoFrame);
+    lastVideoFrameAt = performance.now();
+
+    const prev = lastVideoFrame;
+    lastVideoFrame = metadata;
+    // 카메라 전환 등으로 presentedFrames 가 다시 시작하면 한 프레임 건너뛴다
+    if (prev && metadata.presentedFrames > prev.presentedFrames) {
+        const presented = metadata.presentedFrames - prev.presentedFrames;
+        FrameStats.record('frameTime', (metadata.expectedDisplayTime - prev.expectedDisplayTime) / presented);
+        if (presented > 1) FrameStats.record('drops', presented - 1);
+    }
+    if (metadata.processingDuration !== undefined) {
+        FrameStats.record('processing', metadata.processingDuration * 1000);
+    }
+
+    if (trackerReady && isRunning) updateSceneAnchor();
+    if (renderPending === VIDEO_FRAME_PENDING) animate();
+    if (isVideoRecording()) recordVideoFrame();
+}
+
+// === 장면 고정 (시각 추적 + 자이로 폴백) ===
+// visual-tracker.js 의 호모그래피로 HUD 를 장면에 붙여 둔다.
+// 추적 신뢰도가 떨어지거나 추적기를 쓸 수 없으면 sensor-fusion.js 의 자이로 회전으로 넘긴다.
+// 사용자가 HUD 를 옮기면 그 자리를 새 앵커로 삼는다.
+//   ?track=off: 끔, ?track=gyro: 자이로만, 기본: 시각 추적 + 자이로 폴백
+const TRACKING_MODE = new URLSearchParams(location.search).get('track') || 'auto';
+const TRACKING_MIN_CONFIDENCE = 0.5;
+let trackerReady = false;
+let sensorFusionReady = false;
+let anchorSource = 'none';   // 'visual' | 'gyro' | 'none'
+
+// [x, y, scale, rotation]. 갱신 중 객체를 만들지 않도록 미리 잡아 둔다.
+const hudAnchor = new Float64Array(4);    // 앵커 시점의 HUD 자세
+const trackedPose = new Float64Array(4);  // 추적이 마지막으로 쓴 자세 (사용자 조작 감지용)
+const gyroOffset = new Float32Array(3);
+let hasTrackedPose = false;
+
+const anchorPoint = new Float64Array(2);
+
+function storeTrackedPose() {
+    trackedPose[0] = imgX;
+    trackedPose[1] = imgY;
+    trackedPose[2] = imgScale;
+    trackedPose[3] = imgRotation;
+    hasTrackedPose = true;
+}
+
+function userMovedHud() {
+    return gesture.isDragging || gesture.isPinching || !hasTrackedPose ||
+        trackedPose[0] !== imgX || trackedPose[1] !== imgY ||
+        trackedPose[2] !== imgScale || trackedPose[3] !== imgRotation;
+}
+
+// 현재 HUD 자세를 두 추적기의 새 앵커로 삼는다
+function anchorHudHere(source) {
+    resetTrackerAnchor();
+    if (sensorFusionReady) resetFusionAnchor();
+    hudAnchor[0] = imgX;
+    hudAnchor[1] = imgY;
+    hudAnchor[2] = imgScale;
+    hudAnchor[3] = imgRotation;
+    storeTrackedPose();
+    if (anchorSource !== source) console.log('[AR] HUD 고정 방식:', source);
+    anchorSource = source;
+}
+
+function fallbackSource() {
+    return sensorFusionReady ? 'gyro' : 'none';
+}
+
+function updateSceneAnchor() {
+    let result;
+    try {
+        result = trackVideoFrame(video);
+    } catch (e) {
+        console.warn('[AR] 시각 추적 중단:', e);
+        trackerReady = false;
+        anchorHudHere(fallbackSource());
+        return;
+    }
+    if (!result || !hudImage || !viewport.videoWidth) return;
+
+    if (result.reset || userMovedHud()) {
+        anchorHudHere(result.confidence >= TRACKING_MIN_CONFIDENCE ? 'visual' : fallbackSource());
+        return;
+    }
+    if (result.confidence < TRACKING_MIN_CONFIDENCE) {
+        // 자이로로 넘긴다. 시각 추적 앵커는 복구될 때까지 매 프레임 현재 프레임으로 옮긴다.
+        resetTrackerAnchor();
+        if (anchorSource === 'visual') anchorHudHere(fallbackSource());
+        return;
+    }
+    if (anchorSource !== 'visual') {
+        // 시각 추적 복구: 자이로가 옮겨 둔 자리에서 다시 시작한다
+        anchorHudHere('visual');
+        return;
+    }
+
+    // 추적 프레임은 카메라 프레임을 줄인 것이므로 viewport 의 비디오 좌표에 비율만 곱한다
+    const h = result.homography;
+    const ratio = result.width / viewport.videoWidth;
+    screenToVideo(hudAnchor[0], hudAnchor[1], anchorPoint);
+    const ax = anchorPoint[0] * ratio;
+    const ay = anchorPoint[1] * ratio;
+    const wgt = h[6] * ax + h[7] * ay + h[8];
+    const u = (h[0] * ax + h[1] * ay + h[2]) / wgt;
+    const v = (h[3] * ax + h[4] * ay + h[5]) / wgt;
+    // 앵커 점에서의 야코비안: 행렬식의 제곱근이 국소 배율, 첫 열의 각도가 회전
+    const j00 = (h[0] - h[6] * u) / wgt, j01 = (h[1] - h[7] * u) / wgt;
+    const j10 = (h[3] - h[6] * v) / wgt, j11 = (h[4] - h[7] * v) / wgt;
+    const localScale = Math.sqrt(Math.abs(j00 * j11 - j01 * j10));
+    const localRotation = Math.atan2(j10, j00);
+
+    videoToScreen(u / ratio, v / ratio, anchorPoint);
+    imgX = anchorPoint[0];
+    imgY = anchorPoint[1];
+    imgScale = Math.max(0.3, Math.min(5.0, hudAnchor[2] * localScale));
+    imgRotation = hudAnchor[3] + (viewport.mirror ? -localRotation : localRotation);
+    storeTrackedPose();
+    requestRender();
+}
+
+// devicemotion 마다 호출된다 (sensor-fusion.js)
+function applyGyroPose() {
+    if (anchorSource !== 'gyro' || !hudImage || !video) return;
+    if (userMovedHud()) {
+        anchorHudHere('gyro');
+        return;
+    }
+    readFusionOffset(viewportVideoLongSide() || Math.max(window.innerWidth, window.innerHeight),
+        viewport.mirror, gyroOffset);
+    imgX = hudAnchor[0] + gyroOffset[0];
+    imgY = hudAnchor[1] + gyroOffset[1];
+    imgRotation = hudAnchor[3] + gyroOffset[2];
+    storeTrackedPose();
+    requestRender();
+}
+
+async function initSceneAnchoring() {
+    if (TRACKING_MODE === 'off') return;
+    const [visualOk, gyroOk] = await Promise.all([
+        TRACKING_MODE === 'gyro' ? false : initVisualTracker().catch((e) => {
+            console.warn('[AR] 시각 추적 초기화 실패:', e);
+            return false;
+        }),
+        startSensorFusion(applyGyroPose).catch(() => false),
+    ]);
+    trackerReady = visualOk;
+    sensorFusionReady = gyroOk;
+    // 기다리는 사이 화면을 떠났으면 센서 구독은 재개할 때 다시 한다
+    if (arSuspended) stopSensorFusion();
+    console.log('[AR] 시각 추적:', visualOk ? '사용' : '사용 안 함', '/ 자이로:', gyroOk ? '사용' : '사용 안 함');
+    // 시각 추적이 없으면 자이로로 바로 시작한다 (느린 기기)
+    if (!visualOk && hudImage) anchorHudHere(fallbackSource());
+}
+
+// HUD 이미지가 차지하는 영역 (캔버스 픽셀, 안티에일리어싱 여유 1px 포함)
+// drawX/drawY/drawW/drawH 는 회전 전 사각형, x/y/w/h 는 회전을 포함한 외곽 사각형
+function hudBounds(dpr) {
+    const w = imgW * imgScale * dpr;
+    const h = imgH * imgScale * dpr;
+    const x = imgX * dpr - w / 2;
+    const y = imgY * dpr - h / 2;
+    const cos = Math.abs(Math.cos(imgRotation));
+    const sin = Math.abs(Math.sin(imgRotation));
+    const halfW = (w * cos + h * sin) / 2;
+    const halfH = (w * sin + h * cos) / 2;
+    const left = Math.floor(imgX * dpr - halfW) - 1;
+    const top = Math.floor(imgY * dpr - halfH) - 1;
+    return {
+        x: left,
+        y: top,
+        w: Math.ceil(imgX * dpr + halfW) + 1 - left,
+        h: Math.ceil(imgY * dpr + halfH) + 1 - top,
+        drawX: x, drawY: y, drawW: w, drawH: h, rotation: imgRotation,
+    };
+}
+
+function unionRect(a, b) {
+    if (!a) return b;
+    if (!b) return a;
+    const x = Math.min(a.x, b.x);
+    const y = Math.min(a.y, b.y);
+    return {
+        x, y,
+        w: Math.max(a.x + a.w, b.x + b.w) - x,
+        h: Math.max(a.y + a.h, b.y + b.h) - y,
+    };
+}
+
+// 합성 레이어에 현재 배율로 HUD 이미지를 다시 래스터화한다 (이미지 로딩, 핀치 종료, 리사이즈 때만)
+function rasterizeHudLayer() {
+    if (!hudLayer || !hudImage) return;
+    const dpr = window.devicePixelRatio || 1;
+    const cssW = imgW * imgScale;
+    const cssH = imgH * imgScale;
+    if (videoHud) {
+        // 비디오 HUD 캔버스는 소스 프레임마다 WebGL 로 다시 그려지므로 표시 크기만 맞춘다
+        hudLayer.style.width = cssW + 'px';
+        hudLayer.style.height = cssH + 'px';
+        hudLayerScale = imgScale;
+        requestRender();
+        return;
+    }
+    const pixelScale = Math.min(dpr, HUD_LAYER_MAX_SIZE / Math.max(cssW, cssH));
+
+    hudLayer.width = Math.max(1, Math.round(cssW * pixelScale));
+    hudLayer.height = Math.max(1, Math.round(cssH * pixelScale));
+    hudLayer.style.width = cssW + 'px';
+    hudLayer.style.height = cssH + 'px';
+    const ctx = hudLayer.getContext('2d');
+    ctx.clearRect(0, 0, hudLayer.width, hudLayer.height);
+    ctx.drawImage(pickHudMip(hudLayer.width), 0, 0, hudLayer.width, hudLayer.height);
+    hudLayerScale = imgScale;
+    requestRender();
+}
+
+function scheduleHudRaster(delay) {
+    if (!hudLayer) return;
+    clearTimeout(hudRasterTimer);
+    hudRasterTimer = setTimeout(rasterizeHudLayer, delay);
+}
+
+// HUD 이미지를 ctx 에 그린다. scale 은 CSS 픽셀 -> ctx 픽셀 배율.
+function drawHud(ctx, scale) {
+    if (!hudImage) return;
+    const b = hudBounds(scale);
+    if (!b.rotation) {
+        ctx.drawImage(pickHudMip(b.drawW), b.drawX, b.drawY, b.drawW, b.drawH);
+        return;
+    }
+    ctx.save();
+    ctx.translate(b.drawX + b.drawW / 2, b.drawY + b.drawH / 2);
+    ctx.rotate(b.rotation);
+    ctx.drawImage(pickHudMip(b.drawW), -b.drawW / 2, -b.drawH / 2, b.drawW, b.drawH);
+    ctx.restore();
+}
+
 function animate() {
+    renderPending = 0;
     if (!isRunning) return;
-    requestAnimationFrame(animate);
+
+    if (hudLayer) {
+        // 합성 모드: 레이어 변환 행렬만 바꾼다 (래스터화 없음)
+        if (!hudImage) return;
+        // 레이어 원점(0 0)을 중심으로 옮긴 뒤 회전/배율을 적용한다
+        const halfW = imgW * hudLayerScale / 2;
+        const halfH = imgH * hudLayerScale / 2;
+        hudLayer.style.transform = `translate3d(${imgX}px, ${imgY}px, 0) rotate(${imgRotation}rad) ` +
+            `scale(${imgScale / hudLayerScale}) translate(${-halfW}px, ${-halfH}px)`;
+        hudLayer.style.visibility = 'visible';
+        if (startup.firstFramePending) reportFirstArFrame();
+        return;
+    }
 
     const dpr = window.devicePixelRatio || 1;
-    overlayCtx.clearRect(0, 0, overlayCanvas.width, overlayCanvas.height);
+    const next = hudImage ? hudBounds(dpr) : null;
+
+    if (needsFullClear) {
+        overlayCtx.clearRect(0, 0, overlayCanvas.width, overlayCanvas.height);
+        needsFullClear = false;
+    } else {
+        // 이전 위치와 새 위치를 합친 영역만 지운다
+        const dirty = unionRect(lastDrawnRect, next);
+        if (dirty) overlayCtx.clearRect(dirty.x, dirty.y, dirty.w, dirty.h);
+    }
 
-    if (hudImage) {
-        const w = imgW * imgScale * dpr;
-        const h = imgH * imgScale * dpr;
-        overlayCtx.drawImage(hudImage, imgX * dpr - w / 2, imgY * dpr - h / 2, w, h);
+    if (next) {
+        drawHud(overlayCtx, dpr);
+        if (startup.firstFramePending) reportFirstArFrame();
     }
+    lastDrawnRect = next;
 }
 
 // === 시작 ===
+// DB 는 한 번만 읽고, 탭을 기다리는 동안 이미지 디코드(밉 체인까지)를 끝내 둔다.
+// 같은 문서 안에서 넘어왔으면(image-db.js handOffARImage) DB 를 거치지 않고 디코드된 비트맵을 쓴다.
+// 탭 -> 첫 AR 프레임 시간과, index.html 의 'AR로 보기' 탭부터 잰 시간을 FrameStats 에 남긴다.
+const AR_NAVIGATE_KEY = 'arNavigateStartedAt';
+
+const startup = {
+    tapAt: 0,
+    firstFramePending: false,
+    // 탭을 기다리는 동안의 시작 이미지와 그 디코드 (init 에 넘긴다)
+    source: null,
+    decoded: null,
+    // init 이 도는 동안 넘겨받은 이미지 (init 이 끝나면 바꿔 끼운다)
+    pendingHandoff: null,
+};
+
+async function readStartupImage() {
+    const handoff = takeARImageHandoff();
+    if (handoff) return handoff;
+    const t0 = performance.now();
+    const blob = await getImageFromDB();
+    FrameStats.record('startup.dbRead', performance.now() - t0);
+    return blob ? { blob, bitmap: null } : null;
+}
+
+// 첫 HUD 프레임을 그린 직후 불린다. 다음 rAF 를 화면에 나간 시점으로 본다.
+function reportFirstArFrame() {
+    startup.firstFramePending = false;
+    requestAnimationFrame(() => {
+        const now = performance.now();
+        const tapToFrame = now - startup.tapAt;
+        FrameStats.record('startup.tapToFirstFrame', tapToFrame);
+        let fromNavigate = null;
+        try {
+            const startedAt = Number(sessionStorage.getItem(AR_NAVIGATE_KEY));
+            sessionStorage.removeItem(AR_NAVIGATE_KEY);
+            if (startedAt > 0) {
+                fromNavigate = performance.timeOrigin + now - startedAt;
+                FrameStats.record('startup.navigateToFirstFrame', fromNavigate);
+            }
+        } catch (e) {
+            // sessionStorage 를 쓸 수 없는 환경
+        }
+        console.log('[AR] 탭 -> 첫 AR 프레임:', tapToFrame.toFixed(0) + 'ms',
+            fromNavigate !== null ? '(이전 화면 탭부터 ' + fromNavigate.toFixed(0) + 'ms)' : '');
+    });
+}
+
 (async function start() {
-    let imageBlob = null;
-    try {
-        imageBlob = await getImageFromDB();
-    } catch (e) {
-        console.error('[AR] IndexedDB 에러:', e);
-    }
-    if (!imageBlob) {
-        showError('이미지가 없습니다. 먼저 이미지를 업로드해주세요.');
-        return;
+    let source = null;
+    if (!LIVE_SOURCE && !HUD_VIDEO_URL) {
+        try {
+            source = await readStartupImage();
+        } catch (e) {
+            console.error('[AR] IndexedDB 에러:', e);
+        }
+        if (!source) {
+            showError('이미지가 없습니다. 먼저 이미지를 업로드해주세요.');
+            return;
+        }
     }
+    startup.source = source;
+    startup.decoded = source ? decodeHudImage(source) : Promise.resolve(null);
+    // 실패는 init 에서 카메라와 함께 기다릴 때 알린다
+    startup.decoded.catch(() => {});
+
     const tapEl = document.getElementById('tap-to-start');
     tapEl.addEventListener('click', function onTap() {
         tapEl.removeEventListener('click', onTap);
+        startup.tapAt = performance.now();
+        // iOS 모션 센서 권한은 제스처 안에서 요청해야 한다
+        if (TRACKING_MODE !== 'off') requestMotionPermission();
         tapEl.classList.add('hidden');
-        init();
+        init(startup.source, startup.decoded);
     }, { once: true });
 })();
+
+// === 화면 전환 (router.js) ===
+// index.html 안에서 열렸으면 업로드 화면으로 갈 때 카메라를 닫지 않고 트랙만 꺼 두었다가,
+// 다시 들어오면 켜고 넘겨받은 새 이미지로 바꾼다. getUserMedia / 권한 / 첫 프레임 대기를 다시 하지 않는다.
+// 비디오 HUD(?live / ?video)의 소스도 같이 멈춰서 보이지 않는 동안 분할/디코드가 돌지 않게 한다.
+// ar.html 을 따로 열었으면 예전처럼 index.html 로 이동한다.
+let arSuspended = false;
+let arStarting = false;   // 탭 후 init 이 끝나기 전
+
+function leaveAR() {
+    if (typeof AppRouter !== 'undefined') AppRouter.back('upload');
+    else window.location.href = 'index.html';
+}
+
+function setCameraEnabled(enabled) {
+    const stream = video && video.srcObject;
+    if (!stream) return;
+    stream.getVideoTracks().forEach((track) => { track.enabled = enabled; });
+}
+
+// 화면을 떠날 때는 고르기 화면을 띄우지 않고 연속 촬영 결과를 버린다
+async function discardBurstCapture() {
+    burstPending = false;
+    document.getElementById('btn-capture').classList.remove('burst');
+    const blobs = await finishBurst();
+    console.log('[AR] 화면을 떠나 연속 촬영 취소:', blobs.length + '장 버림');
+}
+
+function suspendAR() {
+    if (!isRunning) return;
+    if (isVideoRecording()) stopRecording();
+    if (burstPending) discardBurstCapture();
+    isRunning = false;
+    arSuspended = true;
+    // 미리 열어 둔 반대쪽 카메라와 센서 구독은 닫는다 (현재 스트림만 남긴다)
+    releaseParkedStreams();
+    stopSensorFusion();
+    if (videoHud === 'live') pauseLiveCutout();
+    if (videoHud === 'chroma') pauseChromaKey();
+    setCameraEnabled(false);
+    video.pause();
+    document.getElementById('hint-overlay').classList.remove('visible');
+    console.log('[AR] 일시정지 (카메라 스트림 유지)');
+}
+
+// 탭 전에 나갔다 들어왔으면 시작 이미지만 새것으로 바꾼다
+function replaceStartupImage(source) {
+    const previous = startup.decoded;
+    startup.source = source;
+    startup.decoded = decodeHudImage(source);
+    startup.decoded.catch(() => {});
+    if (previous) {
+        previous.then((decoded) => {
+            if (decoded) decoded.mips.forEach((mip) => mip.close());
+        }, () => {});
+    }
+}
+
+// 표시 중인 HUD 이미지를 넘겨받은 이미지로 바꾼다. 비디오 HUD 면 쓰지 않고 비트맵만 놓는다.
+async function swapHudImage(handoff) {
+    if (videoHud) {
+        if (handoff.bitmap) handoff.bitmap.close();
+        return;
+    }
+    try {
+        const decoded = await decodeHudImage(handoff);
+        releaseHudMips();
+        if (decoded) installHudImage(decoded);
+        else await loadImageElement(handoff.blob);
+    } catch (e) {
+        if (handoff.bitmap) handoff.bitmap.close();
+        console.error('[AR] 새 이미지 로딩 실패:', e);
+        showToast('이미지를 불러올 수 없습니다');
+    }
+}
+
+async function resumeAR() {
+    const handoff = takeARImageHandoff();
+    if (!arSuspended && !isRunning) {
+        if (!handoff) return;
+        if (arStarting) {
+            // init 이 끝나면 바꿔 끼운다 (그 사이 여러 번 넘어오면 마지막 것만 남긴다)
+            const previous = startup.pendingHandoff;
+            if (previous && previous.bitmap) previous.bitmap.close();
+            startup.pendingHandoff = handoff;
+        } else {
+            replaceStartupImage(handoff);
+        }
+        return;
+    }
+    if (!arSuspended) {
+        // 돌고 있는 중에 다시 들어왔다 (멈추기 전에 돌아온 경우)
+        if (handoff) await swapHudImage(handoff);
+        return;
+    }
+    arSuspended = false;
+    startup.tapAt = performance.now();
+    const swapped = handoff ? swapHudImage(handoff) : null;
+
+    setCameraEnabled(true);
+    try {
+        await Promise.all([
+            video.play(),
+            videoHud === 'live' ? resumeLiveCutout() : null,
+            videoHud === 'chroma' ? resumeChromaKey() : null,
+        ]);
+    } catch (e) {
+        console.warn('[AR] 카메라 재생 재개 실패:', e);
+    }
+    if (swapped) await swapped;
+
+    if (sensorFusionReady) await startSensorFusion(applyGyroPose);
+    // 화면을 떠난 사이 장면이 바뀌었으므로 지금 자리를 새 앵커로 삼는다
+    if (TRACKING_MODE !== 'off') anchorHudHere(anchorSource);
+
+    isRunning = true;
+    startup.firstFramePending = true;
+    requestRender(true);
+    console.log('[AR] 재개:', (performance.now() - startup.tapAt).toFixed(0) + 'ms');
+}
+
+if (typeof AppRouter !== 'undefined') {
+    AppRouter.onLeave('ar', suspendAR);
+    AppRouter.onEnter('ar', resumeAR);
+}
@@ -1,46 +1,166 @@
 // apps-in-toss 네이티브 브릿지 헬퍼
 
+// 진행 중인 호출: eventId -> { method, resolve, reject, timer }
+// 응답 이벤트('<method>/resolve/<id>', '<method>/reject/<id>')는 이 표에서 한 번만 찾아 처리한다.
+var _pendingCalls = new Map();
+var _RESPONSE_EVENT = /^(.+)\/(resolve|reject)\/([^/]+)$/;
+
+// 메서드별 응답 대기 시간 (ms, 0 이면 무제한). default 는 바로 끝나는 데이터 호출에만 적용된다.
+var BRIDGE_TIMEOUTS = {
+    saveBase64Data: 60000,
+    default: 15000
+};
+
+// 사용자가 대화상자/선택 화면에서 고를 때까지 응답이 오지 않는 호출. 시간 제한을 두지 않는다.
+// 여기 없는 메서드를 화면을 띄우는 용도로 부르면 options.timeoutMs 로 0 을 넘긴다.
+var BRIDGE_INTERACTIVE_METHODS = {
+    requestPermission: true,
+    openPermissionDialog: true,
+    fetchAlbumPhotos: true,
+    openCamera: true,
+    share: true
+};
+
+function _bridgeTimeoutMs(method, options) {
+    if (options && options.timeoutMs !== undefined) return options.timeoutMs;
+    if (BRIDGE_INTERACTIVE_METHODS[method]) return 0;
+    return method in BRIDGE_TIMEOUTS ? BRIDGE_TIMEOUTS[method] : BRIDGE_TIMEOUTS.default;
+}
+
+// 응답 이벤트면 대기 중인 호출을 끝내고 true 를 반환한다
+function _settlePendingCall(event, data) {
+    var match = _RESPONSE_EVENT.exec(event);
+    if (!match) return false;
+    var call = _pendingCalls.get(match[3]);
+    if (!call || call.method !== match[1]) return false;
+
+    _pendingCalls.delete(match[3]);
+    if (typeof FrameStats !== 'undefined') FrameStats.record('bridge.' + call.method, performance.now() - call.startedAt);
+    if (call.timer) clearTimeout(call.timer);
+    if (call.unsubscribe) call.unsubscribe();
+    if (match[2] === 'resolve') call.resolve(data);
+    else call.reject(data);
+    return true;
+}
+
 if (!window.__GRANITE_NATIVE_EMITTER) {
     window.__GRANITE_NATIVE_EMITTER = {
-        _events: {},
+        _listeners: new Map(),
+        _pendingTable: true,
         emit: function(event, data) {
-            var cbs = this._events[event] || [];
-            for (var i = 0; i < cbs.length; i++) cbs[i](data);
+            if (_settlePendingCall(event, data)) return;
+            var cbs = this._listeners.get(event);
+            if (!cbs) return;
+            cbs.forEach(function(cb) { cb(data); });
         },
         on: function(event, cb) {
-            var self = this;
-            if (!self._events[event]) self._events[event] = [];
-            self._events[event].push(cb);
+            var listeners = this._listeners;
+            var cbs = listeners.get(event);
+            if (!cbs) {
+                cbs = new Set();
+                listeners.set(event, cbs);
+            }
+            cbs.add(cb);
             return function() {
-                self._events[event] = (self._events[event] || []).filter(function(fn) { return fn !== cb; });
+                cbs.delete(cb);
+                if (cbs.size === 0 && listeners.get(event) === cbs) listeners.delete(event);
             };
         }
     };
 }
 
+// 호출 묶음 전송 (네이티브가 {type: 'batch'} 를 지원할 때만 켠다)
+// 같은 마이크로태스크 안에서 쌓인 호출을 postMessage 한 번으로 보낸다. 응답은 호출별 eventId 로 온다.
+var BRIDGE_BATCHING = {
+    enabled: false
+};
+
+// 같은 인자로 진행 중인 호출이 있으면 새로 보내지 않고 그 결과를 같이 쓴다
+var IDEMPOTENT_METHODS = {
+    requestPermission: true
+};
+
+var _inflightIdempotent = new Map();
+var _batchQueue = [];
+
+function _flushBridgeBatch() {
+    var calls = _batchQueue;
+    _batchQueue = [];
+    if (!window.ReactNativeWebView || calls.length === 0) return;
+    var message = calls.length === 1 ? calls[0] : { type: 'batch', calls: calls };
+    window.ReactNativeWebView.postMessage(JSON.stringify(message));
+}
+
+function _postBridgeMessage(message, batch) {
+    if (!batch) {
+        window.ReactNativeWebView.postMessage(JSON.stringify(message));
+        return;
+    }
+    _batchQueue.push(message);
+    if (_batchQueue.length === 1) queueMicrotask(_flushBridgeBatch);
+}
+
+// 세션 접두사 + 단조 증가 카운터
+var _eventIdPrefix = Date.now().toString(36);
+var _eventIdSeq = 0;
+
 function _nativeEventId() {
-    return Math.random().toString(36).substring(2, 15);
+    _eventIdSeq += 1;
+    return _eventIdPrefix + '-' + _eventIdSeq.toString(36);
+}
+
+function _callBridge(method, params, options) {
+    if (!IDEMPOTENT_METHODS[method]) return _sendBridgeCall(method, params, options);
+
+    var key = method + ':' + JSON.stringify(params);
+    var inflight = _inflightIdempotent.get(key);
+    if (inflight) return inflight;
+    var promise = _sendBridgeCall(method, params, options);
+    _inflightIdempotent.set(key, promise);
+    var forget = function() {
+        if (_inflightIdempotent.get(key) === promise) _inflightIdempotent.delete(key);
+    };
+    promise.then(forget, forget);
+    return promise;
 }
 
-function _callBridge(method, params) {
+function _sendBridgeCall(method, params, options) {
     return new Promise(function(resolve, reject) {
         if (!window.ReactNativeWebView) {
             reject(new Error('bridge_unavailable'));
             return;
         }
         var id = _nativeEventId();
-        var subs = [];
-        subs.push(window.__GRANITE_NATIVE_EMITTER.on(method + '/resolve/' + id, function(data) {
-            subs.forEach(function(fn) { fn(); });
-            resolve(data);
-        }));
-        subs.push(window.__GRANITE_NATIVE_EMITTER.on(method + '/reject/' + id, function(err) {
-            subs.forEach(function(fn) { fn(); });
-            reject(err);
-        }));
-        window.ReactNativeWebView.postMessage(JSON.stringify({
-            type: 'method', functionName: method, eventId: id, args: [params]
-        }));
+        var call = { method: method, resolve: resolve, reject: reject, timer: 0, unsubscribe: null, startedAt: performance.now() };
+
+        var timeoutMs = _bridgeTimeoutMs(method, options);
+        if (timeoutMs > 0) {
+            call.timer = setTimeout(function() {
+                if (_pendingCalls.get(id) !== call) return;
+                _pendingCalls.delete(id);
+                if (call.unsubscribe) call.unsubscribe();
+                reject(new Error('bridge_timeout: ' + method));
+            }, timeoutMs);
+        }
+
+        // 네이티브가 자체 이미터를 주입한 경우에는 응답 이벤트를 구독해서 같은 표로 넘긴다
+        var emitter = window.__GRANITE_NATIVE_EMITTER;
+        if (!emitter._pendingTable) {
+            var offResolve = emitter.on(method + '/resolve/' + id, function(data) {
+                _settlePendingCall(method + '/resolve/' + id, data);
+            });
+            var offReject = emitter.on(method + '/reject/' + id, function(err) {
+                _settlePendingCall(method + '/reject/' + id, err);
+            });
+            call.unsubscribe = function() {
+                offResolve();
+                offReject();
+            };
+        }
+
+        _pendingCalls.set(id, call);
+        var batch = options && options.batch !== undefined ? options.batch : BRIDGE_BATCHING.enabled;
+        _postBridgeMessage({ type: 'method', functionName: method, eventId: id, args: [params] }, batch);
     });
 }
 
@@ -53,22 +173,165 @@ async function _requestCameraPermission() {
     }
 }
 
-async function _saveToGallery(blob) {
-    return new Promise(function(resolve, reject) {
-        var reader = new FileReader();
-        reader.onload = async function(e) {
-            var base64 = e.target.result.split(',')[1];
-            var fileName = 'ar-capture-' + Date.now() + '.jpg';
-            console.log('[AR] base64 길이:', base64.length);
+// 갤러리 저장 옵션
+//   chunkedSave: true 면 saveBase64Data 를 조각 단위로 여러 번 호출한다 (네이티브에서 transferId 로 재조립).
+//                false 면 한 번에 보내되, base64 는 조각별로 만들어 data URL 복사본을 만들지 않는다.
+//                사진(_saveToGallery) 에만 적용된다. 녹화 스트림은 크기 제한이 없으므로 항상 조각으로 보낸다.
+//   chunkBytes:  원본 바이트 기준 조각 크기. base64 조각을 이어 붙일 수 있게 3의 배수여야 한다.
+//   galleryImageTypes: 네이티브 갤러리가 저장할 수 있는 이미지 형식. 네이티브가 WebP/AVIF 를 받으면 여기에 더한다.
+var SAVE_OPTIONS = {
+    chunkedSave: false,
+    chunkBytes: 3 * 256 * 1024,
+    galleryImageTypes: ['image/jpeg']
+};
+
+function _galleryAcceptsImage(mimeType) {
+    return SAVE_OPTIONS.galleryImageTypes.indexOf(mimeType) !== -1;
+}
+
+var _MIME_EXTENSIONS = {
+    'image/jpeg': 'jpg',
+    'image/png': 'png',
+    'image/webp': 'webp',
+    'image/avif': 'avif',
+    'video/mp4': 'mp4',
+    'video/webm': 'webm'
+};
+
+// 바이트 -> base64. String.fromCharCode 인자 수 제한 때문에 32KB 씩 끊어서 변환한다.
+function _bytesToBase64(bytes) {
+    var parts = [];
+    for (var i = 0; i < bytes.length; i += 0x8000) {
+        parts.push(String.fromCharCode.apply(null, bytes.subarray(i, i + 0x8000)));
+    }
+    return btoa(parts.join(''));
+}
+
+async function _blobSliceToBase64(blob, start, end) {
+    return _bytesToBase64(new Uint8Array(await blob.slice(start, end).arrayBuffer()));
+}
+
+function _bridgeErrorMessage(err) {
+    if (err && err.message) return err.message;
+    if (typeof err === 'string') return err;
+    try {
+        return JSON.stringify(err);
+    } catch (e) {
+        return String(err);
+    }
+}
+
+// 전체 크기를 모르는 데이터(녹화 영상)를 만들어지는 대로 저장하는 스트림
+//   chunkBytes 가 찰 때마다 바로 보낸다 (chunkedSave 와 무관). 한 번에 base64 로 바꾸는 것은 한 조각뿐이라
+//   녹화 길이와 상관없이 브리지 메시지 크기와 문자열 메모리가 조각 크기로 묶인다.
+//   조각 수를 미리 모르므로 chunkCount 는 마지막 조각에만 넣고 final: true 를 붙인다.
+function _openGallerySaveStream(mimeType) {
+    var fileName = 'ar-video-' + Date.now() + '.' + (_MIME_EXTENSIONS[mimeType] || 'bin');
+    var transferId = _nativeEventId();
+    var chunkBytes = SAVE_OPTIONS.chunkBytes - SAVE_OPTIONS.chunkBytes % 3;
+    var parts = [];
+    var buffered = 0;
+    var chunkIndex = 0;
+    var sending = Promise.resolve();
+    var written = 0;
+    var aborted = false;
+
+    function sendChunk(blob, last) {
+        var index = chunkIndex++;
+        sending = sending.then(async function() {
+            if (aborted) return;
+            var params = {
+                data: await _blobSliceToBase64(blob, 0, blob.size),
+                fileName: fileName,
+                mimeType: mimeType,
+                transferId: transferId,
+                chunkIndex: index
+            };
+            if (last) {
+                params.chunkCount = index + 1;
+                params.final = true;
+            }
+            await _callBridge('saveBase64Data', params);
+        });
+        // 실패는 close() 에서 한 번만 알린다
+        sending.catch(function() {});
+    }
+
+    return {
+        // part: ArrayBuffer / TypedArray / Blob
+        write: function(part) {
+            var size = part.size !== undefined ? part.size : part.byteLength;
+            parts.push(part);
+            buffered += size;
+            written += size;
+            while (buffered >= chunkBytes) {
+                var pending = new Blob(parts);
+                parts = [pending.slice(chunkBytes)];
+                buffered -= chunkBytes;
+                sendChunk(pending.slice(0, chunkBytes), false);
+            }
+        },
+        bytesWritten: function() {
+            return written;
+        },
+        // 아무것도 쓰지 않고 끝낼 때: 모아 둔 조각을 버리고 더 보내지 않는다
+        abort: function() {
+            aborted = true;
+            parts = [];
+            buffered = 0;
+        },
+        close: async function() {
+            var rest = new Blob(parts, { type: mimeType });
+            parts = [];
+            sendChunk(rest, true);
             try {
-                await _callBridge('saveBase64Data', { data: base64, fileName: fileName, mimeType: 'image/jpeg' });
-                resolve('saved');
+                await sending;
             } catch (bridgeErr) {
-                var msg = bridgeErr && bridgeErr.message ? bridgeErr.message : JSON.stringify(bridgeErr);
+                var msg = _bridgeErrorMessage(bridgeErr);
                 console.error('[AR] saveBase64Data 실패:', msg);
-                reject(new Error('save_failed: ' + msg));
+                throw new Error('save_failed: ' + msg);
             }
-        };
-        reader.readAsDataURL(blob);
-    });
+            console.log('[AR] 스트림 저장 완료:', chunkIndex + '조각', written + 'B');
+            return 'saved';
+        }
+    };
+}
+
+async function _saveToGallery(blob) {
+    var mimeType = blob.type || 'image/jpeg';
+    var fileName = 'ar-capture-' + Date.now() + '.' + (_MIME_EXTENSIONS[mimeType] || 'bin');
+    var chunkBytes = SAVE_OPTIONS.chunkBytes - SAVE_OPTIONS.chunkBytes % 3;
+
+    try {
+        if (SAVE_OPTIONS.chunkedSave && blob.size > chunkBytes) {
+            var transferId = _nativeEventId();
+            var chunkCount = Math.ceil(blob.size / chunkBytes);
+            for (var i = 0; i < chunkCount; i++) {
+                var data = await _blobSliceToBase64(blob, i * chunkBytes, (i + 1) * chunkBytes);
+                await _callBridge('saveBase64Data', {
+                    data: data,
+                    fileName: fileName,
+                    mimeType: mimeType,
+                    transferId: transferId,
+                    chunkIndex: i,
+                    chunkCount: chunkCount
+                });
+            }
+            console.log('[AR] 분할 저장 완료:', chunkCount + '조각', blob.size + 'B');
+        } else {
+            var pieces = [];
+            for (var offset = 0; offset < blob.size; offset += chunkBytes) {
+                pieces.push(await _blobSliceToBase64(blob, offset, offset + chunkBytes));
+            }
+            var base64 = pieces.join('');
+            pieces = null;
+            console.log('[AR] base64 길이:', base64.length);
+            await _callBridge('saveBase64Data', { data: base64, fileName: fileName, mimeType: mimeType });
+        }
+        return 'saved';
+    } catch (bridgeErr) {
+        var msg = _bridgeErrorMessage(bridgeErr);
+        console.error('[AR] saveBase64Data 실패:', msg);
+        throw new Error('save_failed: ' + msg);
+    }
 }
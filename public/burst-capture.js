@@ -0,0 +1,148 @@
+// 연속 촬영 (캡처 버튼을 누르고 있는 동안)
+// 캡처 크기 캔버스 슬롯을 미리 잡아 두고, 한 장은 슬롯에 합성(GPU 복사)만 한다.
+// JPEG 인코딩은 인코딩 큐가 한 장씩 나중에 처리하고, 빈 슬롯이 없으면 그 장은 건너뛴다.
+// 그래서 버튼을 오래 눌러도 메모리는 슬롯 수만큼만 쓴다.
+
+const BURST_OPTIONS = {
+    intervalMs: 100,
+    maxShots: 20,
+    // 슬롯 픽셀 메모리 상한 (RGBA). 슬롯 수는 이 안에서 minSlots..maxSlots 로 정한다.
+    memoryBudgetBytes: 96 * 1024 * 1024,
+    minSlots: 2,
+    maxSlots: 8,
+};
+
+const burst = {
+    slots: [],           // { canvas, ctx, busy }
+    width: 0,
+    height: 0,
+    queue: [],           // 인코딩을 기다리는 슬롯
+    encoding: false,
+    active: false,
+    timer: 0,
+    shots: 0,
+    skipped: 0,
+    results: [],         // 인코딩된 Blob (촬영 순서)
+    encode: null,
+    draw: null,
+    idleWaiters: [],
+};
+
+function burstSlotCount(width, height) {
+    const perSlot = width * height * 4;
+    const fit = Math.floor(BURST_OPTIONS.memoryBudgetBytes / perSlot);
+    return Math.max(BURST_OPTIONS.minSlots, Math.min(BURST_OPTIONS.maxSlots, fit));
+}
+
+// 캡처 크기가 바뀌었을 때만 슬롯을 다시 만든다
+function ensureBurstSlots(width, height) {
+    if (burst.width === width && burst.height === height && burst.slots.length) return;
+    burst.slots = [];
+    const count = burstSlotCount(width, height);
+    for (let i = 0; i < count; i++) {
+        const canvas = document.createElement('canvas');
+        canvas.width = width;
+        canvas.height = height;
+        burst.slots.push({ canvas, ctx: canvas.getContext('2d', { alpha: false }), busy: false });
+    }
+    burst.width = width;
+    burst.height = height;
+    Resources.hold('burstSlots', 'canvas', count * width * height * 4, null);
+    console.log('[AR] 연속 촬영 슬롯:', count + '개', width + 'x' + height);
+}
+
+function takeBurstShot() {
+    if (burst.shots >= BURST_OPTIONS.maxShots) {
+        stopBurst();
+        return;
+    }
+    const slot = burst.slots.find((s) => !s.busy);
+    if (!slot) {
+        // 인코딩이 밀렸다: 메모리를 더 잡지 않고 이 장은 버린다
+        burst.skipped++;
+        return;
+    }
+    const t0 = performance.now();
+    slot.busy = true;
+    burst.draw(slot.ctx, burst.width, burst.height);
+    FrameStats.record('burstShotMs', performance.now() - t0);
+    burst.shots++;
+    burst.queue.push({ slot, index: burst.results.length });
+    burst.results.push(null);
+    pumpBurstEncoder();
+}
+
+// 인코딩은 한 번에 한 장. encode(slot.canvas) 는 캔버스 내용을 복사해 간 뒤 release() 를 부르고 Blob 을 돌려준다.
+async function pumpBurstEncoder() {
+    if (burst.encoding) return;
+    const job = burst.queue.shift();
+    if (!job) {
+        burst.idleWaiters.splice(0).forEach((resolve) => resolve());
+        return;
+    }
+    burst.encoding = true;
+    const release = () => { job.slot.busy = false; };
+    try {
+        burst.results[job.index] = await burst.encode(job.slot.canvas, release);
+    } catch (e) {
+        console.warn('[AR] 연속 촬영 인코딩 실패:', e);
+    } finally {
+        release();
+        burst.encoding = false;
+    }
+    pumpBurstEncoder();
+}
+
+function waitBurstIdle() {
+    if (!burst.encoding && burst.queue.length === 0) return Promise.resolve();
+    return new Promise((resolve) => burst.idleWaiters.push(resolve));
+}
+
+// draw(ctx, width, height): 슬롯에 현재 화면 한 장을 합성한다
+// encode(canvas, release): Blob 을 돌려주는 Promise
+function startBurst(width, height, draw, encode) {
+    if (burst.active) return;
+    ensureBurstSlots(width, height);
+    burst.active = true;
+    burst.shots = 0;
+    burst.skipped = 0;
+    burst.results = [];
+    burst.draw = draw;
+    burst.encode = encode;
+    takeBurstShot();
+    burst.timer = setInterval(takeBurstShot, BURST_OPTIONS.intervalMs);
+}
+
+function stopBurst() {
+    if (!burst.active) return;
+    burst.active = false;
+    clearInterval(burst.timer);
+    burst.timer = 0;
+}
+
+function isBurstActive() {
+    return burst.active;
+}
+
+// 연속 촬영을 멈추고 남은 인코딩이 끝나면 Blob 목록을 돌려준다
+async function finishBurst() {
+    stopBurst();
+    await waitBurstIdle();
+    const blobs = burst.results.filter(Boolean);
+    console.log('[AR] 연속 촬영 완료:', blobs.length + '장', '건너뜀:', burst.skipped);
+    burst.results = [];
+    return blobs;
+}
+
+// 앱이 백그라운드로 가면 슬롯 메모리를 돌려준다
+function releaseBurstSlots() {
+    if (burst.active || burst.encoding) return;
+    for (const slot of burst.slots) {
+        slot.canvas.width = 0;
+        slot.canvas.height = 0;
+    }
+    burst.slots = [];
+    burst.width = 0;
+    burst.height = 0;
+    Resources.release('burstSlots');
+}
@@ -0,0 +1,99 @@
+// 카메라 해상도/프레임레이트 선택
+// 미리보기는 화면을 cover 로 채우는 데 필요한 만큼만, 캡처할 때만 트랙 최대 해상도로 올린다.
+
+// 성능 등급별 미리보기 상한 (긴 변 픽셀, fps)
+const CAMERA_TIERS = {
+    low: { maxLongSide: 960, frameRate: 24 },
+    mid: { maxLongSide: 1280, frameRate: 30 },
+    high: { maxLongSide: 1920, frameRate: 30 },
+};
+
+// 카메라가 보통 지원하는 16:9 긴 변 단계
+const CAMERA_LONG_SIDES = [640, 960, 1280, 1920, 2560, 3840];
+
+let cameraPerfTier = null;
+
+// 코어 수, 메모리, 짧은 연산 벤치마크로 기기 등급을 정한다 (세션 동안 캐시)
+function measurePerfTier() {
+    if (cameraPerfTier) return cameraPerfTier;
+    const cached = sessionStorage.getItem('cameraPerfTier');
+    if (cached && CAMERA_TIERS[cached]) return (cameraPerfTier = cached);
+
+    const t0 = performance.now();
+    let acc = 0;
+    for (let i = 0; i < 2e6; i++) acc += Math.sqrt(i) * 0.5;
+    const benchMs = performance.now() - t0 + (acc > 0 ? 0 : 1);
+
+    const cores = navigator.hardwareConcurrency || 4;
+    const memory = navigator.deviceMemory || 4;
+    let tier = 'mid';
+    if (cores <= 4 || memory <= 2 || benchMs > 20) tier = 'low';
+    else if (cores >= 8 && memory >= 6 && benchMs < 8) tier = 'high';
+
+    console.log('[AR] 성능 등급:', tier, `(cores=${cores}, memory=${memory}GB, bench=${benchMs.toFixed(1)}ms)`);
+    sessionStorage.setItem('cameraPerfTier', tier);
+    return (cameraPerfTier = tier);
+}
+
+// 화면(DPR 포함)을 덮는 데 필요한 긴 변을 표준 단계로 올리고 등급 상한으로 자른다
+function previewLongSide(tier) {
+    const dpr = window.devicePixelRatio || 1;
+    const need = Math.max(window.innerWidth, window.innerHeight) * dpr;
+    const cap = CAMERA_TIERS[tier].maxLongSide;
+    let side = CAMERA_LONG_SIDES.find((s) => s >= need) || CAMERA_LONG_SIDES[CAMERA_LONG_SIDES.length - 1];
+    if (side > cap) side = cap;
+    return side;
+}
+
+// getUserMedia/applyConstraints 용 video 제약
+//   purpose 'preview': 화면 크기/성능 등급에 맞춘 해상도
+//   purpose 'capture': 트랙이 지원하는 최대 해상도 (capabilities 없으면 4K 를 ideal 로 요청)
+function pickCameraConstraints(facing, purpose = 'preview', track = null) {
+    const tier = measurePerfTier();
+    const frameRate = CAMERA_TIERS[tier].frameRate;
+
+    if (purpose === 'capture') {
+        const caps = track && track.getCapabilities ? track.getCapabilities() : null;
+        const width = caps && caps.width && caps.width.max ? caps.width.max : 3840;
+        const height = caps && caps.height && caps.height.max ? caps.height.max : 2160;
+        return { facingMode: facing, width: { ideal: width }, height: { ideal: height }, frameRate: { ideal: frameRate } };
+    }
+
+    const long = previewLongSide(tier);
+    const short = Math.round(long * 9 / 16);
+    return {
+        facingMode: facing,
+        width: { ideal: long },
+        height: { ideal: short },
+        frameRate: { ideal: frameRate, max: frameRate },
+    };
+}
+
+// 스트림을 다시 열지 않고 트랙 해상도를 바꾼 뒤 새 해상도의 프레임이 올 때까지 기다린다
+async function applyCameraConstraints(videoEl, track, constraints, timeoutMs = 800) {
+    const before = videoEl.videoWidth + 'x' + videoEl.videoHeight;
+    await track.applyConstraints(constraints);
+    const settings = track.getSettings ? track.getSettings() : {};
+    if (!settings.width || !settings.height) return;
+
+    await new Promise((resolve) => {
+        const matches = () => {
+            const w = videoEl.videoWidth;
+            const h = videoEl.videoHeight;
+            return (w === settings.width && h === settings.height) || (w === settings.height && h === settings.width);
+        };
+        if (matches()) {
+            resolve();
+            return;
+        }
+        const done = () => {
+            clearTimeout(tid);
+            videoEl.removeEventListener('resize', onResize);
+            resolve();
+        };
+        const onResize = () => { if (matches()) done(); };
+        const tid = setTimeout(done, timeoutMs);
+        videoEl.addEventListener('resize', onResize);
+    });
+    console.log('[AR] 카메라 해상도 변경:', before, '->', videoEl.videoWidth + 'x' + videoEl.videoHeight);
+}
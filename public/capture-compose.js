@@ -0,0 +1,61 @@
+// 캡처 합성 (ar.js 메인 스레드 폴백 / capture-worker.js 공용)
+// layout 은 ar.js 의 captureLayout() 이 화면 상태로부터 계산한다.
+//   width, height: 출력 크기
+//   videoSize:     레이아웃을 계산할 때의 비디오 해상도
+//   video:         videoSize 기준 cover 소스 영역 { sx, sy, sw, sh }
+//   mirror:        전면 카메라 좌우 반전
+//   hud:           HUD 이미지 위치 { x, y, w, h, rotation } 또는 null (rotation 은 중심 기준 라디안)
+//   logo:          워터마크 위치 { x, y, w, h } 또는 null (null 이면 텍스트 표시)
+
+function frameSize(frame) {
+    return {
+        width: frame.displayWidth || frame.videoWidth || frame.width,
+        height: frame.displayHeight || frame.videoHeight || frame.height
+    };
+}
+
+function composeCapture(ctx, layout, frame, hud, logo) {
+    var w = layout.width;
+    var h = layout.height;
+    ctx.clearRect(0, 0, w, h);
+
+    // 캡처한 프레임 해상도가 레이아웃 기준과 다를 수 있으므로 비율로 맞춘다
+    var size = frameSize(frame);
+    if (size.width > 0 && size.height > 0 && layout.videoSize.width > 0) {
+        var fx = size.width / layout.videoSize.width;
+        var fy = size.height / layout.videoSize.height;
+        var v = layout.video;
+        if (layout.mirror) {
+            ctx.save();
+            ctx.scale(-1, 1);
+            ctx.drawImage(frame, v.sx * fx, v.sy * fy, v.sw * fx, v.sh * fy, -w, 0, w, h);
+            ctx.restore();
+        } else {
+            ctx.drawImage(frame, v.sx * fx, v.sy * fy, v.sw * fx, v.sh * fy, 0, 0, w, h);
+        }
+    }
+
+    if (hud && layout.hud) {
+        var r = layout.hud;
+        if (r.rotation) {
+            ctx.save();
+            ctx.translate(r.x + r.w / 2, r.y + r.h / 2);
+            ctx.rotate(r.rotation);
+            ctx.drawImage(hud, -r.w / 2, -r.h / 2, r.w, r.h);
+            ctx.restore();
+        } else {
+            ctx.drawImage(hud, r.x, r.y, r.w, r.h);
+        }
+    }
+
+    if (logo && layout.logo) {
+        ctx.save();
+        ctx.globalAlpha = 0.6;
+        ctx.drawImage(logo, layout.logo.x, layout.logo.y, layout.logo.w, layout.logo.h);
+        ctx.restore();
+    } else {
+        ctx.fillStyle = 'rgba(255, 255, 255, 0.7)';
+        ctx.font = 'bold 30px sans-serif';
+        ctx.fillText('LOGO', w - 150, h - 50);
+    }
+}
@@ -0,0 +1,58 @@
+// 캡처 워커: 카메라 프레임 + HUD + 로고를 OffscreenCanvas 에 합성하고 메인 스레드가 고른 형식으로 인코딩한다.
+// 연속 촬영 슬롯은 메인 스레드에서 합성이 끝난 비트맵으로 와서 인코딩만 한다.
+// 캔버스는 하나를 계속 재사용하고, 받은 VideoFrame/ImageBitmap 은 여기서 닫는다.
+
+importScripts('capture-compose.js', 'image-encoder.js');
+
+let canvas = null;
+let ctx = null;
+let logo = null;
+
+function pooledContext(width, height) {
+    if (!canvas) {
+        canvas = new OffscreenCanvas(width, height);
+        ctx = canvas.getContext('2d');
+    } else if (canvas.width !== width || canvas.height !== height) {
+        canvas.width = width;
+        canvas.height = height;
+    }
+    return ctx;
+}
+
+async function capture(msg) {
+    const { layout, frame, hud } = msg;
+    try {
+        composeCapture(pooledContext(layout.width, layout.height), layout, frame, hud, logo);
+    } finally {
+        frame.close();
+        if (hud) hud.close();
+    }
+    return ImageEncoder.encode(canvas, msg.mimeType, msg.quality, 'capture');
+}
+
+// 연속 촬영: 이미 합성된 슬롯 복사본을 인코딩만 한다
+async function encode(msg) {
+    const { bitmap } = msg;
+    try {
+        pooledContext(bitmap.width, bitmap.height).drawImage(bitmap, 0, 0);
+    } finally {
+        bitmap.close();
+    }
+    return ImageEncoder.encode(canvas, msg.mimeType, msg.quality, 'burst');
+}
+
+self.onmessage = async (e) => {
+    const msg = e.data;
+    if (msg.type === 'logo') {
+        if (logo) logo.close();
+        logo = msg.bitmap;
+        return;
+    }
+    if (msg.type !== 'capture' && msg.type !== 'encode') return;
+    try {
+        const blob = msg.type === 'encode' ? await encode(msg) : await capture(msg);
+        self.postMessage({ type: 'done', id: msg.id, blob });
+    } catch (err) {
+        self.postMessage({ type: 'error', id: msg.id, message: err && err.message ? err.message : String(err) });
+    }
+};
@@ -0,0 +1,146 @@
+// 크로마키 비디오 HUD (window.changeARVideo)
+// 초록 배경 영상을 소스 프레임마다 WebGL 텍스처로 올리고 키잉은 전부 프래그먼트 셰이더에서 한다.
+// 픽셀을 CPU 로 읽어 오지 않으므로(getImageData 없음) 영상 원래 프레임레이트로 돈다.
+
+const CHROMA_KEY_DEFAULTS = {
+    keyColor: [0, 1, 0],   // RGB 0..1
+    similarity: 0.12,      // 이 CbCr 거리까지는 완전히 투명
+    smoothness: 0.08,      // 그 뒤 이 폭만큼 부드럽게 불투명해진다
+    spill: 0.15,           // 경계 근처 초록 번짐을 휘도 쪽으로 빼는 폭
+};
+// 출력 캔버스 긴 변 (픽셀)
+const CHROMA_KEY_MAX_SIDE = 1280;
+
+// BT.601 YCbCr 에서 키 색상과의 색차 거리로 알파를 만들고, 키에 가까운 부분은 채도를 빼서 번짐을 줄인다.
+// 결과는 premultiplied alpha.
+const CHROMA_KEY_SHADER = `
+precision mediump float;
+varying vec2 v_uv;
+uniform sampler2D u_video;
+uniform vec2 u_keyCbCr;
+uniform vec3 u_params;
+vec2 toCbCr(vec3 rgb, float y) {
+    return vec2((rgb.b - y) * 0.564, (rgb.r - y) * 0.713);
+}
+void main() {
+    vec3 rgb = texture2D(u_video, v_uv).rgb;
+    float y = dot(rgb, vec3(0.299, 0.587, 0.114));
+    float d = distance(toCbCr(rgb, y), u_keyCbCr);
+    float a = smoothstep(u_params.x, u_params.x + u_params.y, d);
+    float spill = 1.0 - smoothstep(u_params.x, u_params.x + u_params.y + u_params.z, d);
+    rgb = mix(rgb, vec3(y), spill);
+    gl_FragColor = vec4(rgb * a, a);
+}`;
+
+const chromaKey = {
+    canvas: null,
+    gl: null,
+    program: null,
+    texture: null,
+    source: null,
+    options: CHROMA_KEY_DEFAULTS,
+    onFrame: null,
+};
+
+function keyCbCr(rgb) {
+    const y = 0.299 * rgb[0] + 0.587 * rgb[1] + 0.114 * rgb[2];
+    return [(rgb[2] - y) * 0.564, (rgb[0] - y) * 0.713];
+}
+
+// '#00ff00' 또는 [r, g, b] (0..1)
+function parseKeyColor(color) {
+    if (Array.isArray(color)) return color;
+    const hex = /^#?([0-9a-f]{6})$/i.exec(color || '');
+    if (!hex) return CHROMA_KEY_DEFAULTS.keyColor;
+    const n = parseInt(hex[1], 16);
+    return [(n >> 16 & 255) / 255, (n >> 8 & 255) / 255, (n & 255) / 255];
+}
+
+function drawChromaFrame() {
+    const ck = chromaKey;
+    const gl = ck.gl;
+    const key = keyCbCr(ck.options.keyColor);
+    gl.viewport(0, 0, ck.canvas.width, ck.canvas.height);
+    gl.useProgram(ck.program);
+    gl.activeTexture(gl.TEXTURE0);
+    uploadVideoTexture(gl, ck.texture, ck.source);
+    gl.uniform1i(gl.getUniformLocation(ck.program, 'u_video'), 0);
+    gl.uniform2f(gl.getUniformLocation(ck.program, 'u_keyCbCr'), key[0], key[1]);
+    gl.uniform3f(gl.getUniformLocation(ck.program, 'u_params'),
+        ck.options.similarity, ck.options.smoothness, ck.options.spill);
+    gl.drawArrays(gl.TRIANGLE_STRIP, 0, 4);
+}
+
+function onChromaFrame(now, metadata) {
+    const source = chromaKey.source;
+    if (!source) return;
+    source.requestVideoFrameCallback(onChromaFrame);
+    const t0 = performance.now();
+    drawChromaFrame();
+    FrameStats.record('chromaKeyMs', performance.now() - t0);
+    if (chromaKey.onFrame) chromaKey.onFrame();
+}
+
+async function openChromaSource(url) {
+    const source = document.createElement('video');
+    source.muted = true;
+    source.loop = true;
+    source.playsInline = true;
+    source.setAttribute('playsinline', '');
+    source.crossOrigin = 'anonymous';
+    source.src = url;
+    await source.play();
+    if (typeof source.requestVideoFrameCallback !== 'function') {
+        source.pause();
+        throw new Error('requestVideoFrameCallback 미지원');
+    }
+    return source;
+}
+
+// 영상을 크로마키 캔버스로 재생한다. 이미 재생 중이면 같은 캔버스에서 소스만 바꾼다.
+// 영상 비율이 바뀌면 캔버스 크기도 바뀌므로 호출 측은 onFrame 에서 canvas 크기를 확인한다.
+async function playChromaKeyVideo(url, options, onFrame) {
+    const ck = chromaKey;
+    const source = await openChromaSource(url);
+    const size = fitLongSide(source.videoWidth, source.videoHeight, CHROMA_KEY_MAX_SIDE);
+    if (!ck.gl) {
+        const { canvas, gl } = createHudGLCanvas(size.width, size.height);
+        ck.canvas = canvas;
+        ck.gl = gl;
+        ck.program = compileHudProgram(gl, CHROMA_KEY_SHADER);
+        ck.texture = createHudTexture(gl);
+    } else {
+        ck.canvas.width = size.width;
+        ck.canvas.height = size.height;
+    }
+    // 이전 클립은 디코더와 버퍼까지 놓는다 (pause 만 하면 바꿀 때마다 디코더가 하나씩 남는다)
+    if (ck.source) releaseChromaSource(ck.source);
+    ck.source = source;
+    ck.onFrame = onFrame;
+    ck.options = Object.assign({}, CHROMA_KEY_DEFAULTS, options, {
+        keyColor: parseKeyColor(options && options.keyColor),
+    });
+    source.requestVideoFrameCallback(onChromaFrame);
+    console.log('[AR] 크로마키 영상:', url, source.videoWidth + 'x' + source.videoHeight);
+    return ck.canvas;
+}
+
+// 화면을 떠나 있는 동안 클립 재생(디코드와 그리기)을 멈춘다
+function pauseChromaKey() {
+    if (chromaKey.source) chromaKey.source.pause();
+}
+
+function resumeChromaKey() {
+    return chromaKey.source ? chromaKey.source.play() : Promise.resolve();
+}
+
+function releaseChromaSource(source) {
+    source.pause();
+    source.removeAttribute('src');
+    source.load();
+}
+
+function stopChromaKey() {
+    if (chromaKey.source) releaseChromaSource(chromaKey.source);
+    chromaKey.source = null;
+}
@@ -0,0 +1,181 @@
+// 성능 통계 (항상 켜져 있는 링 버퍼)
+// 프레임 시간, 드롭, 캡처 지연, 브리지 왕복 시간 등을 이름별로 최근 RING_SIZE 개씩 모은다.
+// 보유 메모리처럼 현재 값만 의미 있는 지표는 게이지(gauge)로 마지막 값과 최대값만 둔다.
+// ?debug 로 열거나 콘솔에서 FrameStats.toggleOverlay() 로 숨은 오버레이를 연다.
+
+(function(global) {
+    var RING_SIZE = 600;
+    var DROP_WINDOW_MS = 60000;
+    var rings = {};
+    var gauges = {};
+
+    function createRing() {
+        return { values: new Float64Array(RING_SIZE), times: new Float64Array(RING_SIZE), head: 0, count: 0 };
+    }
+
+    function record(name, value) {
+        if (!(value >= 0)) return;
+        var ring = rings[name] || (rings[name] = createRing());
+        ring.values[ring.head] = value;
+        ring.times[ring.head] = performance.now();
+        ring.head = (ring.head + 1) % RING_SIZE;
+        if (ring.count < RING_SIZE) ring.count++;
+    }
+
+    function gauge(name, value) {
+        var g = gauges[name] || (gauges[name] = { value: 0, max: 0 });
+        g.value = value;
+        if (value > g.max) g.max = value;
+    }
+
+    function percentile(sorted, p) {
+        if (sorted.length === 0) return 0;
+        var idx = Math.min(sorted.length - 1, Math.floor(p * sorted.length));
+        return sorted[idx];
+    }
+
+    function summarizeRing(ring) {
+        var sorted = ring.values.slice(0, ring.count).sort();
+        var sum = 0;
+        for (var i = 0; i < sorted.length; i++) sum += sorted[i];
+        return {
+            count: ring.count,
+            p50: percentile(sorted, 0.5),
+            p95: percentile(sorted, 0.95),
+            max: sorted.length ? sorted[sorted.length - 1] : 0,
+            mean: sorted.length ? sum / sorted.length : 0
+        };
+    }
+
+    // 최근 1분 동안 기록된 'drops' 값의 합
+    function dropsPerMinute() {
+        var ring = rings.drops;
+        if (!ring) return 0;
+        var since = performance.now() - DROP_WINDOW_MS;
+        var total = 0;
+        for (var i = 0; i < ring.count; i++) {
+            if (ring.times[i] >= since) total += ring.values[i];
+        }
+        return total;
+    }
+
+    function summary() {
+        var out = { dropsPerMinute: dropsPerMinute(), metrics: {}, gauges: {} };
+        Object.keys(gauges).forEach(function(name) {
+            out.gauges[name] = { value: gauges[name].value, max: gauges[name].max };
+        });
+        Object.keys(rings).forEach(function(name) {
+            if (name !== 'drops') out.metrics[name] = summarizeRing(rings[name]);
+        });
+        return out;
+    }
+
+    function exportJSON() {
+        var raw = {};
+        Object.keys(rings).forEach(function(name) {
+            var ring = rings[name];
+            var start = ring.count < RING_SIZE ? 0 : ring.head;
+            var samples = [];
+            for (var i = 0; i < ring.count; i++) {
+                var j = (start + i) % RING_SIZE;
+                samples.push([Math.round(ring.times[j]), ring.values[j]]);
+            }
+            raw[name] = samples;
+        });
+        return JSON.stringify({
+            userAgent: navigator.userAgent,
+            devicePixelRatio: global.devicePixelRatio || 1,
+            crossOriginIsolated: global.crossOriginIsolated === true,
+            exportedAt: new Date().toISOString(),
+            summary: summary(),
+            samples: raw
+        }, null, 2);
+    }
+
+    function reset() {
+        rings = {};
+        gauges = {};
+    }
+
+    // === 디버그 오버레이 ===
+    var overlay = null;
+    var overlayText = null;
+    var overlayTimer = 0;
+
+    function format(s) {
+        var lines = ['drops/min ' + s.dropsPerMinute];
+        Object.keys(s.metrics).forEach(function(name) {
+            var m = s.metrics[name];
+            lines.push(name + '  p50 ' + m.p50.toFixed(1) + '  p95 ' + m.p95.toFixed(1) + '  n=' + m.count);
+        });
+        Object.keys(s.gauges).forEach(function(name) {
+            var g = s.gauges[name];
+            var unit = /Bytes$/.test(name) ? 1024 * 1024 : 1;
+            lines.push(name + '  ' + (g.value / unit).toFixed(1) + '  max ' + (g.max / unit).toFixed(1) + (unit > 1 ? ' MB' : ''));
+        });
+        return lines.join('\n');
+    }
+
+    function downloadJSON() {
+        var blob = new Blob([exportJSON()], { type: 'application/json' });
+        var url = URL.createObjectURL(blob);
+        var a = document.createElement('a');
+        a.href = url;
+        a.download = 'frame-stats-' + Date.now() + '.json';
+        document.body.appendChild(a);
+        a.click();
+        document.body.removeChild(a);
+        setTimeout(function() { URL.revokeObjectURL(url); }, 1000);
+    }
+
+    function createOverlay() {
+        overlay = document.createElement('div');
+        overlay.style.cssText = 'position:fixed;top:80px;left:10px;z-index:2000;padding:8px 10px;' +
+            'background:rgba(0,0,0,0.7);color:#C8E6C9;font:11px/1.4 monospace;border-radius:8px;';
+        overlayText = document.createElement('pre');
+        overlayText.style.margin = '0 0 6px';
+        var button = document.createElement('button');
+        button.textContent = 'JSON 내보내기';
+        button.style.cssText = 'font:11px sans-serif;padding:4px 8px;';
+        button.addEventListener('click', function() {
+            console.log('[Stats]', exportJSON());
+            downloadJSON();
+        });
+        overlay.appendChild(overlayText);
+        overlay.appendChild(button);
+        document.body.appendChild(overlay);
+    }
+
+    function toggleOverlay(show) {
+        if (show === undefined) show = !overlayTimer;
+        if (!show) {
+            clearInterval(overlayTimer);
+            overlayTimer = 0;
+            if (overlay) overlay.style.display = 'none';
+            return;
+        }
+        if (!overlay) createOverlay();
+        overlay.style.display = 'block';
+        var update = function() { overlayText.textContent = format(summary()); };
+        update();
+        if (!overlayTimer) overlayTimer = setInterval(update, 1000);
+    }
+
+    if (typeof document !== 'undefined') {
+        document.addEventListener('DOMContentLoaded', function() {
+            if (new URLSearchParams(location.search).has('debug')) toggleOverlay(true);
+        });
+        document.addEventListener('keydown', function(e) {
+            if (e.shiftKey && (e.key === 'D' || e.key === 'd')) toggleOverlay();
+        });
+    }
+
+    global.FrameStats = {
+        record: record,
+        gauge: gauge,
+        summary: summary,
+        exportJSON: exportJSON,
+        reset: reset,
+        toggleOverlay: toggleOverlay
+    };
+})(self);
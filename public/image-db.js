@@ -0,0 +1,132 @@
+// ARImageDB 헬퍼 (index.html / ar.html 공용)
+//   images:       AR 화면으로 넘길 현재 이미지 (id: 'arImage')
+//   segmentCache: 입력 파일 해시 -> 배경 제거 결과. lastUsed 기준 LRU 로 용량을 제한한다.
+// 같은 문서 안에서 AR 화면으로 넘어갈 때는 handOffARImage() 로 디코드해 둔 비트맵을 DB 를 거치지 않고 넘긴다.
+
+var IMAGE_DB_NAME = 'ARImageDB';
+var IMAGE_DB_VERSION = 2;
+
+var SEGMENT_CACHE_OPTIONS = {
+    maxBytes: 50 * 1024 * 1024
+};
+
+// 연결은 페이지당 하나만 열어 두고 같이 쓴다. 다른 탭이 버전을 올리면 닫고 다음 호출에서 다시 연다.
+var _imageDB = null;
+
+function openImageDB() {
+    if (_imageDB) return _imageDB;
+    _imageDB = new Promise(function(resolve, reject) {
+        var request = indexedDB.open(IMAGE_DB_NAME, IMAGE_DB_VERSION);
+        request.onerror = function() {
+            _imageDB = null;
+            reject(request.error);
+        };
+        request.onsuccess = function() {
+            var db = request.result;
+            db.onversionchange = function() {
+                db.close();
+                _imageDB = null;
+            };
+            db.onclose = function() { _imageDB = null; };
+            resolve(db);
+        };
+        request.onupgradeneeded = function(e) {
+            var db = e.target.result;
+            if (!db.objectStoreNames.contains('images')) {
+                db.createObjectStore('images', { keyPath: 'id' });
+            }
+            if (!db.objectStoreNames.contains('segmentCache')) {
+                var store = db.createObjectStore('segmentCache', { keyPath: 'key' });
+                store.createIndex('lastUsed', 'lastUsed');
+            }
+        };
+    });
+    return _imageDB;
+}
+
+async function saveImageToDB(blob) {
+    var db = await openImageDB();
+    return new Promise(function(resolve, reject) {
+        var tx = db.transaction('images', 'readwrite');
+        tx.objectStore('images').put({ id: 'arImage', blob: blob });
+        tx.oncomplete = function() { resolve(); };
+        tx.onerror = function() { reject(tx.error); };
+    });
+}
+
+async function getImageFromDB() {
+    var db = await openImageDB();
+    return new Promise(function(resolve, reject) {
+        var request = db.transaction('images', 'readonly').objectStore('images').get('arImage');
+        request.onsuccess = function() {
+            resolve(request.result && request.result.blob ? request.result.blob : null);
+        };
+        request.onerror = function() { reject(request.error); };
+    });
+}
+
+// 캐시 조회. 적중하면 lastUsed 를 갱신하고 결과 Blob 을, 아니면 null 을 돌려준다.
+async function getCachedCutout(key) {
+    var db = await openImageDB();
+    return new Promise(function(resolve, reject) {
+        var tx = db.transaction('segmentCache', 'readwrite');
+        var store = tx.objectStore('segmentCache');
+        var found = null;
+        var request = store.get(key);
+        request.onsuccess = function() {
+            var entry = request.result;
+            if (!entry) return;
+            found = entry.blob;
+            entry.lastUsed = Date.now();
+            store.put(entry);
+        };
+        tx.oncomplete = function() { resolve(found); };
+        tx.onerror = function() { reject(tx.error); };
+    });
+}
+
+// 캐시 저장 후 오래 안 쓴 항목부터 지워 maxBytes 이하로 맞춘다
+async function putCachedCutout(key, blob) {
+    var db = await openImageDB();
+    return new Promise(function(resolve, reject) {
+        var tx = db.transaction('segmentCache', 'readwrite');
+        var store = tx.objectStore('segmentCache');
+        store.put({ key: key, blob: blob, size: blob.size, lastUsed: Date.now() });
+
+        var entries = [];
+        var total = 0;
+        var cursorReq = store.index('lastUsed').openCursor();
+        cursorReq.onsuccess = function() {
+            var cursor = cursorReq.result;
+            if (cursor) {
+                entries.push({ key: cursor.value.key, size: cursor.value.size });
+                total += cursor.value.size;
+                cursor.continue();
+                return;
+            }
+            for (var i = 0; i < entries.length && total > SEGMENT_CACHE_OPTIONS.maxBytes; i++) {
+                if (entries[i].key === key) continue;
+                store.delete(entries[i].key);
+                total -= entries[i].size;
+            }
+        };
+        tx.oncomplete = function() { resolve(); };
+        tx.onerror = function() { reject(tx.error); };
+    });
+}
+
+// === 같은 문서 안 전달 ===
+// { blob, bitmap }. bitmap 은 premultiplyAlpha: 'premultiply' 로 디코드한 원본 해상도 ImageBitmap (없으면 null).
+var _arImageHandoff = null;
+
+function handOffARImage(blob, bitmap) {
+    if (_arImageHandoff && _arImageHandoff.bitmap && _arImageHandoff.bitmap !== bitmap) _arImageHandoff.bitmap.close();
+    _arImageHandoff = { blob: blob, bitmap: bitmap || null };
+}
+
+// 넘겨받은 이미지를 한 번만 꺼낸다 (소유권도 함께 넘어간다)
+function takeARImageHandoff() {
+    var handoff = _arImageHandoff;
+    _arImageHandoff = null;
+    return handoff;
+}
@@ -0,0 +1,142 @@
+// 이미지 인코더 선택 (메인 스레드 / 워커 공용)
+//   컷아웃: IndexedDB 에 저장되고 ar.html 이 열릴 때마다 다시 디코드되므로 무손실 WebP 를 쓴다.
+//           캔버스가 무손실 WebP 를 만들면 그대로, 못 만들면 Wasm 인코더(wasm/kernels.js), 둘 다 안 되면 PNG.
+//   캡처:   선호 순서 중 캔버스가 실제로 만들 수 있고 호출 측이 받는다고 한 첫 형식을 쓴다.
+// 지원 여부는 작은 캔버스로 한 번 인코딩해 보고 기억한다. 인코딩 시간과 크기는 콘솔(과 FrameStats)에 남긴다.
+
+(function(global) {
+    // Wasm 인코더는 전체 해상도 버퍼를 한 번에 잡으므로 이 화소 수까지만 쓰고 넘으면 PNG 로 간다
+    var WASM_WEBP_MAX_PIXELS = 12 * 1000 * 1000;
+    var PROBE_SIZE = 4;
+
+    var probes = {};
+
+    function createCanvas(width, height) {
+        if (typeof OffscreenCanvas !== 'undefined') return new OffscreenCanvas(width, height);
+        var canvas = document.createElement('canvas');
+        canvas.width = width;
+        canvas.height = height;
+        return canvas;
+    }
+
+    // 형식을 지원하지 않으면 브라우저는 PNG 로 바꿔 만든다. 실패하면 null.
+    function canvasToBlob(canvas, type, quality) {
+        if (canvas.convertToBlob) return canvas.convertToBlob({ type: type, quality: quality });
+        return new Promise(function(resolve) { canvas.toBlob(resolve, type, quality); });
+    }
+
+    // 불투명 픽셀은 이웃과 색이 크게 달라 손실 압축이면 값이 바뀌고, 투명 픽셀은 알파 보존을 본다
+    function probePixels() {
+        var data = new Uint8ClampedArray(PROBE_SIZE * PROBE_SIZE * 4);
+        for (var i = 0; i < PROBE_SIZE * PROBE_SIZE; i++) {
+            var transparent = i % 5 === 0;
+            data[i * 4] = transparent ? 0 : (i * 73) & 255;
+            data[i * 4 + 1] = transparent ? 0 : (i * 151 + 40) & 255;
+            data[i * 4 + 2] = transparent ? 0 : (255 - i * 29) & 255;
+            data[i * 4 + 3] = transparent ? 0 : 255;
+        }
+        return data;
+    }
+
+    async function runProbe(type, lossless) {
+        var canvas = createCanvas(PROBE_SIZE, PROBE_SIZE);
+        var ctx = canvas.getContext('2d');
+        var source = probePixels();
+        ctx.putImageData(new ImageData(source, PROBE_SIZE, PROBE_SIZE), 0, 0);
+        var blob = await canvasToBlob(canvas, type, lossless ? 1 : 0.8);
+        if (!blob || blob.type !== type) return false;
+        if (!lossless) return true;
+        if (typeof createImageBitmap !== 'function') return false;
+
+        var bitmap = await createImageBitmap(blob);
+        ctx.clearRect(0, 0, PROBE_SIZE, PROBE_SIZE);
+        ctx.drawImage(bitmap, 0, 0);
+        bitmap.close();
+        var decoded = ctx.getImageData(0, 0, PROBE_SIZE, PROBE_SIZE).data;
+        for (var i = 0; i < source.length; i++) {
+            if (decoded[i] !== source[i]) return false;
+        }
+        return true;
+    }
+
+    // type 을 (lossless 면 무손실로) 만들 수 있는지. 결과는 형식별로 한 번만 구한다.
+    function probe(type, lossless) {
+        var key = type + (lossless ? ':lossless' : '');
+        if (!probes[key]) {
+            probes[key] = runProbe(type, lossless).catch(function() { return false; });
+        }
+        return probes[key];
+    }
+
+    function report(label, path, width, height, blob, t0) {
+        var ms = performance.now() - t0;
+        console.log('[Encoder] ' + label + ':', path, width + 'x' + height,
+            (blob.size / 1024).toFixed(0) + 'KB', ms.toFixed(1) + 'ms');
+        if (typeof FrameStats !== 'undefined') {
+            FrameStats.record(label + 'EncodeMs', ms);
+            if (FrameStats.gauge) FrameStats.gauge(label + 'Bytes', blob.size);
+        }
+    }
+
+    // 캔버스를 지정 형식으로 인코딩하고 시간/크기를 남긴다
+    async function encode(canvas, type, quality, label) {
+        var t0 = performance.now();
+        var blob = await canvasToBlob(canvas, type, quality);
+        if (blob) report(label, blob.type, canvas.width, canvas.height, blob, t0);
+        return blob;
+    }
+
+    function wasmEncoderAvailable(width, height) {
+        return width * height <= WASM_WEBP_MAX_PIXELS &&
+            typeof ImageKernels !== 'undefined' && typeof ImageKernels.encodeWebPLossless === 'function';
+    }
+
+    // 컷아웃(알파 있음)을 무손실로 인코딩한다. ctx 는 canvas 의 2D 컨텍스트 (Wasm 경로에서 픽셀을 읽는다).
+    async function encodeCutout(canvas, ctx) {
+        var w = canvas.width;
+        var h = canvas.height;
+        var blob = null;
+
+        if (await probe('image/webp', true)) {
+            var t0 = performance.now();
+            blob = await canvasToBlob(canvas, 'image/webp', 1);
+            if (blob && blob.type === 'image/webp') {
+                report('cutout', 'webp-native', w, h, blob, t0);
+                return blob;
+            }
+        }
+
+        if (wasmEncoderAvailable(w, h) && await ImageKernels.load()) {
+            var t1 = performance.now();
+            var bytes = ImageKernels.encodeWebPLossless(ctx.getImageData(0, 0, w, h).data, w, h);
+            if (bytes) {
+                blob = new Blob([bytes], { type: 'image/webp' });
+                report('cutout', 'webp-wasm', w, h, blob, t1);
+                return blob;
+            }
+        }
+
+        var t2 = performance.now();
+        blob = await canvasToBlob(canvas, 'image/png');
+        if (blob) report('cutout', 'png', w, h, blob, t2);
+        return blob;
+    }
+
+    // candidates: [{ type, quality }] 선호 순. accepts(type) 가 false 인 형식은 건너뛴다.
+    // 맞는 것이 없으면 마지막 후보(보통 JPEG)를 돌려준다.
+    async function pickFormat(candidates, accepts) {
+        for (var i = 0; i < candidates.length - 1; i++) {
+            var candidate = candidates[i];
+            if (accepts && !accepts(candidate.type)) continue;
+            if (await probe(candidate.type, false)) return candidate;
+        }
+        return candidates[candidates.length - 1];
+    }
+
+    global.ImageEncoder = {
+        probe: probe,
+        encode: encode,
+        encodeCutout: encodeCutout,
+        pickFormat: pickFormat
+    };
+})(self);
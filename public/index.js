@@ -1,18 +1,179 @@
+// 배경 제거 설정
+//   mode 'full': 원본 파일을 그대로 모델에 넣는다
+//   mode 'fast': 모델 해상도로 줄여서 추론하고, 마스크만 원본 해상도로 업샘플링한다 (?mode=fast)
+var SEGMENTATION_OPTIONS = {
+    model: 'medium',
+    mode: new URLSearchParams(location.search).get('mode') === 'fast' ? 'fast' : 'full',
+    modelResolution: 1024
+};
+
+var BG_LIBRARY_URL = 'https://cdn.jsdelivr.net/npm/@imgly/background-removal@1.5.1/+esm';
+
+// build.js 가 자산을 public/vendor 에 받아 두었으면 같은 출처에서 불러온다
+var BG_VENDOR_MANIFEST_URL = 'vendor/imgly/manifest.json';
+var bgPublicPath = null;
+
+async function resolveLibraryUrl() {
+    try {
+        var res = await fetch(BG_VENDOR_MANIFEST_URL, { cache: 'no-cache' });
+        var type = res.headers.get('Content-Type') || '';
+        if (res.ok && type.indexOf('json') !== -1) {
+            var manifest = await res.json();
+            bgPublicPath = new URL(manifest.publicPath, location.href).href;
+            return new URL(manifest.library, location.href).href;
+        }
+    } catch (e) {
+        console.warn('[Upload] 자체 호스팅 자산 확인 실패, CDN 사용:', e.message);
+    }
+    return BG_LIBRARY_URL;
+}
+
+// 워밍업과 실제 호출이 같은 세션을 쓰도록 설정은 한 곳에서 만든다
+function segmentationConfig(progress) {
+    var config = {
+        model: SEGMENTATION_OPTIONS.model,
+        output: { format: 'image/png', quality: 0.9 },
+        progress: progress
+    };
+    if (bgPublicPath) config.publicPath = bgPublicPath;
+    return config;
+}
+
+// 단계별 소요 시간 (ms)
+var uploadTimings = {};
+
+function recordTiming(name, start) {
+    uploadTimings[name] = Math.round(performance.now() - start);
+    console.log('[Upload] 타이밍', name + ':', uploadTimings[name] + 'ms');
+}
+
+// 교차 출처 격리 여부 (server.js 의 COOP/COEP).
+// 격리된 페이지에서만 onnxruntime 이 다중 스레드로 돈다.
+var CROSS_ORIGIN_ISOLATED = window.crossOriginIsolated === true;
+console.log('[Upload] crossOriginIsolated:', CROSS_ORIGIN_ISOLATED,
+    CROSS_ORIGIN_ISOLATED ? '(다중 스레드 백엔드 사용 가능)' : '(단일 스레드 백엔드)');
+
+// 모델/런타임 자산을 Cache Storage 에 보관하는 서비스 워커
+if ('serviceWorker' in navigator) {
+    navigator.serviceWorker.register('sw.js').catch(function(e) {
+        console.warn('[Upload] 서비스 워커 등록 실패:', e);
+    });
+}
+
 // 배경 제거 라이브러리 동적 로딩 (페이지 렌더링 차단 방지)
 var removeBackground = null;
+var warmUpPromise = null;
 
 (async function loadLibrary() {
+    var t0 = performance.now();
     try {
-        var mod = await import('https://cdn.jsdelivr.net/npm/@imgly/background-removal@1.5.1/+esm');
+        var mod = await import(await resolveLibraryUrl());
         removeBackground = mod.removeBackground;
+        recordTiming('libraryImport', t0);
         console.log('[Upload] 배경 제거 라이브러리 로드 완료');
+        warmUpPromise = warmUpModel(mod);
     } catch (e) {
         console.error('[Upload] 라이브러리 로드 실패:', e);
     }
 })();
 
+function createDummyImage() {
+    var canvas = document.createElement('canvas');
+    canvas.width = 32;
+    canvas.height = 32;
+    var ctx = canvas.getContext('2d');
+    ctx.fillStyle = '#7CB342';
+    ctx.fillRect(8, 8, 16, 16);
+    return new Promise(function(resolve) { canvas.toBlob(resolve, 'image/png'); });
+}
+
+// 사용자가 파일을 고르는 동안 모델 가중치를 받고 작은 이미지로 추론을 한 번 돌려 둔다
+async function warmUpModel(mod) {
+    if (navigator.connection && navigator.connection.saveData) return;
+    try {
+        var t0 = performance.now();
+        if (mod.preload) {
+            await mod.preload(segmentationConfig());
+            recordTiming('modelPreload', t0);
+        }
+        var t1 = performance.now();
+        await mod.removeBackground(await createDummyImage(), segmentationConfig());
+        recordTiming('warmUpInference', t1);
+    } catch (e) {
+        console.warn('[Upload] 모델 워밍업 실패:', e);
+    }
+}
+
 var processedImageBlob = null;
 
+// 후처리 워커 (OffscreenCanvas 미지원 시 메인 스레드에서 처리)
+var uploadWorker = null;
+var workerJobs = {};
+var workerJobSeq = 0;
+
+function canUseUploadWorker() {
+    return typeof Worker !== 'undefined' &&
+        typeof OffscreenCanvas !== 'undefined' &&
+        typeof OffscreenCanvas.prototype.convertToBlob === 'function' &&
+        typeof createImageBitmap === 'function';
+}
+
+function getUploadWorker() {
+    if (uploadWorker) return uploadWorker;
+    uploadWorker = new Worker('upload-worker.js');
+    uploadWorker.onmessage = function(e) {
+        var msg = e.data;
+        var job = workerJobs[msg.id];
+        if (!job) return;
+        if (msg.type === 'progress') {
+            if (job.onProgress) job.onProgress(msg.stage, msg.ratio);
+            return;
+        }
+        delete workerJobs[msg.id];
+        if (msg.type === 'done') job.resolve(msg.result);
+        else job.reject(new Error(msg.message));
+    };
+    uploadWorker.onerror = function(e) {
+        console.error('[Upload] 워커 오류:', e.message);
+        Object.keys(workerJobs).forEach(function(id) {
+            workerJobs[id].reject(new Error(e.message || 'worker_error'));
+        });
+        workerJobs = {};
+        uploadWorker = null;
+    };
+    return uploadWorker;
+}
+
+// Blob 은 구조화 복제로 참조만 넘어가므로 픽셀 데이터 복사는 일어나지 않는다
+function runUploadJob(type, payload, onProgress) {
+    return new Promise(function(resolve, reject) {
+        var id = ++workerJobSeq;
+        workerJobs[id] = { resolve: resolve, reject: reject, onProgress: onProgress };
+        var msg = Object.assign({ type: type, id: id }, payload);
+        getUploadWorker().postMessage(msg);
+    });
+}
+
+// 업로드 크기 상한. 워커는 알파 초크를 타일로 나눠 처리해 작업 메모리가 해상도와 무관하지만,
+// 메인 스레드 폴백은 전체 해상도 ImageData 를 한 번에 잡으므로 예전 상한을 유지한다.
+var MAX_UPLOAD_BYTES_TILED = 40 * 1024 * 1024;
+var MAX_UPLOAD_BYTES_FALLBACK = 10 * 1024 * 1024;
+
+function maxUploadBytes() {
+    return canUseUploadWorker() ? MAX_UPLOAD_BYTES_TILED : MAX_UPLOAD_BYTES_FALLBACK;
+}
+
+function maxUploadMB() {
+    return Math.round(maxUploadBytes() / (1024 * 1024));
+}
+
+// 모델 추론 동안 워커와 Wasm 커널을 미리 준비해 둔다
+if (canUseUploadWorker()) {
+    getUploadWorker();
+} else {
+    ImageKernels.load();
+}
+
 document.addEventListener('DOMContentLoaded', function() {
     console.log('[Upload] DOM 로드 완료');
     initApp();
@@ -34,6 +195,9 @@ function initApp() {
     var arButton = document.getElementById('ar-button');
     var errorMessage = document.getElementById('error-message');
 
+    // 상한은 워커 사용 여부에 따라 다르므로 안내 문구도 여기서 채운다
+    document.getElementById('upload-hint').textContent = 'JPG, PNG, WebP 지원 (최대 ' + maxUploadMB() + 'MB)';
+
     galleryBtn.onclick = function() {
         fileInput.removeAttribute('capture');
         fileInput.click();
@@ -77,9 +241,11 @@ function initApp() {
         goToAR();
     };
 
+    if (typeof AppRouter !== 'undefined') AppRouter.onEnter('upload', resetUploadView);
+
     async function handleFile(file) {
-        if (file.size > 10 * 1024 * 1024) {
-            showError('파일 크기가 너무 큽니다 (최대 10MB)');
+        if (file.size > maxUploadBytes()) {
+            showError('파일 크기가 너무 큽니다 (최대 ' + maxUploadMB() + 'MB)');
             return;
         }
         if (!file.type.startsWith('image/')) {
@@ -88,20 +254,25 @@ function initApp() {
         }
         hideError();
 
-        var reader = new FileReader();
-        reader.onload = function(e) {
-            previewImage.src = e.target.result;
+        // 새 입력을 받으면 이전 입력/결과는 바로 놓는다
+        Resources.holdBlob('input', file);
+        Resources.release('result');
+        Resources.release('resultBlob');
+        processedImageBlob = null;
+
+        Resources.renderPreview('preview', previewImage, file, previewWidth()).then(function() {
             previewInfo.textContent = file.name + ' (' + formatFileSize(file.size) + ')';
             previewContainer.classList.add('visible');
-        };
-        reader.readAsDataURL(file);
+        }).catch(function(e) {
+            console.warn('[Upload] 미리보기 실패:', e);
+        });
 
         await processImage(file);
     }
 
     async function chokeAlpha(blob, amount) {
         amount = amount || 2;
-        return new Promise(function(resolve) {
+        return new Promise(function(resolve, reject) {
             var img = new Image();
             img.onload = function() {
                 var canvas = document.createElement('canvas');
@@ -115,59 +286,127 @@ function initApp() {
                 var w = canvas.width;
                 var h = canvas.height;
 
-                var alphaOrig = new Uint8Array(w * h);
-                for (var i = 0; i < w * h; i++) {
-                    alphaOrig[i] = data[i * 4 + 3];
-                }
-
-                for (var pass = 0; pass < amount; pass++) {
-                    var alphaCopy = new Uint8Array(alphaOrig);
-                    for (var y = 1; y < h - 1; y++) {
-                        for (var x = 1; x < w - 1; x++) {
-                            var idx = y * w + x;
-                            var minAlpha = alphaCopy[idx];
-                            for (var dy = -1; dy <= 1; dy++) {
-                                for (var dx = -1; dx <= 1; dx++) {
-                                    var nIdx = (y + dy) * w + (x + dx);
-                                    minAlpha = Math.min(minAlpha, alphaCopy[nIdx]);
-                                }
-                            }
-                            alphaOrig[idx] = minAlpha;
-                        }
-                    }
-                }
-
-                for (var i = 0; i < w * h; i++) {
-                    data[i * 4 + 3] = alphaOrig[i];
-                }
+                ImageKernels.chokeAlpha(data, w, h, amount);
                 ctx.putImageData(imageData, 0, 0);
+                imageData = null;
+                URL.revokeObjectURL(img.src);
 
-                canvas.toBlob(function(resultBlob) {
-                    URL.revokeObjectURL(img.src);
+                ImageEncoder.encodeCutout(canvas, ctx).then(function(resultBlob) {
+                    canvas.width = 0;
+                    canvas.height = 0;
                     resolve(resultBlob);
-                }, 'image/png');
+                }, reject);
+            };
+            img.onerror = function() {
+                URL.revokeObjectURL(img.src);
+                reject(new Error('이미지 디코드 실패'));
             };
             img.src = URL.createObjectURL(blob);
         });
     }
 
+    function onPostProgress(stage, ratio) {
+        progressFill.style.width = (90 + ratio * 10) + '%';
+        progressText.textContent = stage === 'encode' ? '마무리 중...' : '테두리 정리 중...';
+    }
+
+    // 알파 초크 + 무손실 인코딩. 가능하면 워커에서, 아니면 메인 스레드에서 처리한다.
+    async function postProcess(blob, radius) {
+        if (canUseUploadWorker()) {
+            try {
+                return await runUploadJob('choke', { blob: blob, radius: radius }, onPostProgress);
+            } catch (e) {
+                console.warn('[Upload] 워커 후처리 실패, 메인 스레드로 재시도:', e.message);
+            }
+        }
+        return chokeAlpha(blob, radius);
+    }
+
+    // 빠른 모드 후처리: 저해상도 결과의 알파를 원본 해상도로 업샘플링해서 원본에 입힌다
+    async function refineCutout(original, lowResBlob, radius) {
+        try {
+            return await runUploadJob('refine', { blob: original, mask: lowResBlob, radius: radius }, onPostProgress);
+        } catch (e) {
+            console.warn('[Upload] 마스크 업샘플링 실패, 저해상도 결과 사용:', e.message);
+            return postProcess(lowResBlob, radius);
+        }
+    }
+
+    // 입력 바이트 해시 + 처리 옵션으로 캐시 키를 만든다. 해시를 못 구하면 null.
+    async function segmentCacheKey(file, radius) {
+        if (!canUseUploadWorker() || !window.indexedDB) return null;
+        try {
+            var hash = await runUploadJob('hash', { blob: file });
+            return [hash, SEGMENTATION_OPTIONS.model, SEGMENTATION_OPTIONS.mode, radius].join('|');
+        } catch (e) {
+            console.warn('[Upload] 입력 해시 실패, 캐시 건너뜀:', e.message);
+            return null;
+        }
+    }
+
+    // 미리보기는 화면 폭에 맞춘 축소 비트맵만 둔다
+    function previewWidth() {
+        return Math.min(1080, window.innerWidth * (window.devicePixelRatio || 1));
+    }
+
+    function showResult() {
+        Resources.holdBlob('resultBlob', processedImageBlob);
+        Resources.renderPreview('result', resultImage, processedImageBlob, previewWidth()).catch(function(e) {
+            console.warn('[Upload] 결과 미리보기 실패:', e);
+        });
+        resultContainer.classList.add('visible');
+        arButton.classList.add('visible');
+    }
+
     async function processImage(file) {
+        var chokeRadius = 1;
+        resultContainer.classList.remove('visible');
+        arButton.classList.remove('visible');
+
+        var cacheKey = await segmentCacheKey(file, chokeRadius);
+        if (cacheKey) {
+            try {
+                var cached = await getCachedCutout(cacheKey);
+                if (cached) {
+                    console.log('[Upload] 세그멘테이션 캐시 적중');
+                    processedImageBlob = cached;
+                    progressContainer.classList.remove('visible');
+                    showResult();
+                    return;
+                }
+            } catch (e) {
+                console.warn('[Upload] 캐시 조회 실패:', e);
+            }
+        }
+
         if (!removeBackground) {
             showError('배경 제거 라이브러리를 로딩 중입니다. 잠시 후 다시 시도해주세요.');
             return;
         }
 
         progressContainer.classList.add('visible');
-        resultContainer.classList.remove('visible');
-        arButton.classList.remove('visible');
         progressFill.style.width = '0%';
         progressText.textContent = '모델 로딩 중...';
 
+        var cutoutStart = performance.now();
         try {
-            var rawBlob = await removeBackground(file, {
-                model: 'medium',
-                output: { format: 'image/png', quality: 0.9 },
-                progress: function(key, current, total) {
+            // 워밍업 추론과 겹치지 않게 끝날 때까지 기다린다
+            if (warmUpPromise) await warmUpPromise;
+
+            // 빠른 모드: 모델 해상도로 줄인 입력으로 마스크만 얻는다
+            var segmentInput = null;
+            if (SEGMENTATION_OPTIONS.mode === 'fast' && canUseUploadWorker()) {
+                try {
+                    segmentInput = await runUploadJob('downscale', {
+                        blob: file, maxSide: SEGMENTATION_OPTIONS.modelResolution
+                    });
+                } catch (e) {
+                    console.warn('[Upload] 입력 축소 실패, 원본으로 진행:', e.message);
+                }
+            }
+
+            var rawBlob = await removeBackground(segmentInput || file, segmentationConfig(
+                function(key, current, total) {
                     var percent = Math.round((current / total) * 100);
                     progressFill.style.width = (percent * 0.9) + '%';
                     if (percent < 30) {
@@ -178,18 +417,24 @@ function initApp() {
                         progressText.textContent = '배경 제거 중...';
                     }
                 }
-            });
+            ));
 
             progressText.textContent = '테두리 정리 중...';
-            progressFill.style.width = '95%';
-            processedImageBlob = await chokeAlpha(rawBlob, 1);
+            progressFill.style.width = '90%';
+            processedImageBlob = segmentInput
+                ? await refineCutout(file, rawBlob, chokeRadius)
+                : await postProcess(rawBlob, chokeRadius);
 
             progressFill.style.width = '100%';
             progressText.textContent = '완료!';
+            recordTiming('cutout', cutoutStart);
+            showResult();
 
-            resultImage.src = URL.createObjectURL(processedImageBlob);
-            resultContainer.classList.add('visible');
-            arButton.classList.add('visible');
+            if (cacheKey) {
+                putCachedCutout(cacheKey, processedImageBlob).catch(function(e) {
+                    console.warn('[Upload] 캐시 저장 실패:', e);
+                });
+            }
 
             setTimeout(function() {
                 progressContainer.classList.remove('visible');
@@ -201,28 +446,13 @@ function initApp() {
         }
     }
 
-    function openImageDB() {
-        return new Promise(function(resolve, reject) {
-            var request = indexedDB.open('ARImageDB', 1);
-            request.onerror = function() { reject(request.error); };
-            request.onsuccess = function() { resolve(request.result); };
-            request.onupgradeneeded = function(e) {
-                var db = e.target.result;
-                if (!db.objectStoreNames.contains('images')) {
-                    db.createObjectStore('images', { keyPath: 'id' });
-                }
-            };
-        });
-    }
-
-    async function saveImageToDB(blob) {
-        var db = await openImageDB();
-        return new Promise(function(resolve, reject) {
-            var tx = db.transaction('images', 'readwrite');
-            tx.objectStore('images').put({ id: 'arImage', blob: blob });
-            tx.oncomplete = function() { db.close(); resolve(); };
-            tx.onerror = function() { db.close(); reject(tx.error); };
-        });
+    // ar.js 가 이 시각부터 첫 AR 프레임까지를 잰다 (ar.html 을 따로 열 때도 있으므로 epoch 기준 ms 로 넘긴다)
+    function markARNavigateStart() {
+        try {
+            sessionStorage.setItem('arNavigateStartedAt', String(performance.timeOrigin + performance.now()));
+        } catch (e) {
+            // sessionStorage 를 쓸 수 없으면 측정만 건너뛴다
+        }
     }
 
     async function goToAR() {
@@ -230,9 +460,17 @@ function initApp() {
             alert('먼저 이미지를 업로드하고 배경 제거를 완료해주세요.');
             return;
         }
+        markARNavigateStart();
         try {
             arButton.querySelector('span').textContent = '로딩 중...';
             arButton.style.pointerEvents = 'none';
+            // 새로고침/단독 ar.html 은 DB 에서 읽으므로 라우터로 넘어가도 저장은 해 둔다
+            if (typeof AppRouter !== 'undefined') {
+                var results = await Promise.all([saveImageToDB(processedImageBlob), decodeForAR(processedImageBlob)]);
+                handOffARImage(processedImageBlob, results[1]);
+                await AppRouter.navigate('ar');
+                return;
+            }
             await saveImageToDB(processedImageBlob);
             window.location.href = 'ar.html';
         } catch (err) {
@@ -242,6 +480,32 @@ function initApp() {
         }
     }
 
+    // ar.js 의 decodeHudImage 가 그대로 쓰는 형식 (원본 해상도, premultiply). 실패하면 AR 쪽이 blob 을 디코드한다.
+    function decodeForAR(blob) {
+        if (typeof createImageBitmap !== 'function') return Promise.resolve(null);
+        return createImageBitmap(blob, { premultiplyAlpha: 'premultiply' }).catch(function(e) {
+            console.warn('[Upload] AR 이미지 미리 디코드 실패:', e);
+            return null;
+        });
+    }
+
+    // AR 화면에서 돌아오면 처음 열었을 때처럼 비운다 (모델과 워커는 그대로 둔다)
+    function resetUploadView() {
+        Resources.release('input');
+        Resources.release('preview');
+        Resources.release('result');
+        Resources.release('resultBlob');
+        processedImageBlob = null;
+        fileInput.value = '';
+        previewContainer.classList.remove('visible');
+        progressContainer.classList.remove('visible');
+        resultContainer.classList.remove('visible');
+        arButton.classList.remove('visible');
+        arButton.querySelector('span').textContent = 'AR로 보기';
+        arButton.style.pointerEvents = 'auto';
+        hideError();
+    }
+
     function showError(message) {
         errorMessage.textContent = message;
         errorMessage.classList.add('visible');
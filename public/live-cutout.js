@@ -0,0 +1,262 @@
+// 실시간 인물 컷아웃 (?live=camera 또는 ?live=<영상 URL>)
+// 두 번째 소스(반대쪽 카메라 또는 영상 클립)를 MediaPipe Selfie Segmentation 으로 N 프레임마다 분할하고,
+// 마스크는 WebGL 셰이더에서 이전 마스크와 섞어(시간 평활) 소스 프레임에 적용한다. CPU 픽셀 루프는 없다.
+// 분할은 WebGL(GPU delegate) 을 먼저 쓰고, 안 되면 MediaPipe 의 Wasm SIMD(CPU delegate) 로 돈다.
+
+const LIVE_CUTOUT = {
+    libraryUrl: 'https://cdn.jsdelivr.net/npm/@mediapipe/tasks-vision@0.10.14/vision_bundle.mjs',
+    wasmRoot: 'https://cdn.jsdelivr.net/npm/@mediapipe/tasks-vision@0.10.14/wasm',
+    modelUrl: 'https://storage.googleapis.com/mediapipe-models/image_segmenter/selfie_segmenter/float16/1/selfie_segmenter.tflite',
+    // 출력 캔버스 긴 변 (픽셀)
+    maxSide: 512,
+    // 소스 프레임당 분할 예산. 분할 시간이 넘치면 분할 간격을 늘린다 (1..maxInterval 프레임).
+    budgetMs: 8,
+    maxInterval: 6,
+    // 새 마스크 비중 (나머지는 이전 평활 마스크)
+    maskBlend: 0.6,
+    // 알파 부드러운 경계 (smoothstep 구간)
+    edge: [0.35, 0.65],
+};
+
+// 새 마스크와 이전 평활 마스크를 섞는다 (텍스처 행 순서를 그대로 유지하도록 gl_FragCoord 로 샘플링)
+const BLEND_SHADER = `
+precision mediump float;
+uniform sampler2D u_mask;
+uniform sampler2D u_prev;
+uniform vec2 u_size;
+uniform float u_blend;
+void main() {
+    vec2 uv = gl_FragCoord.xy / u_size;
+    float m = mix(texture2D(u_prev, uv).r, texture2D(u_mask, uv).r, u_blend);
+    gl_FragColor = vec4(m, m, m, 1.0);
+}`;
+
+// 소스 프레임에 평활 마스크를 알파로 적용한다 (premultiplied 출력)
+const COMPOSITE_SHADER = `
+precision mediump float;
+varying vec2 v_uv;
+uniform sampler2D u_video;
+uniform sampler2D u_mask;
+uniform float u_mirror;
+uniform vec2 u_edge;
+void main() {
+    vec2 uv = v_uv;
+    if (u_mirror > 0.5) uv.x = 1.0 - uv.x;
+    vec3 rgb = texture2D(u_video, uv).rgb;
+    float a = smoothstep(u_edge.x, u_edge.y, texture2D(u_mask, uv).r);
+    gl_FragColor = vec4(rgb * a, a);
+}`;
+
+const liveCutout = {
+    canvas: null,
+    gl: null,
+    source: null,
+    stream: null,
+    mirror: false,
+    segmenter: null,
+    programs: null,
+    videoTex: null,
+    maskTex: null,
+    smoothTex: [null, null],
+    smoothFbo: [null, null],
+    smoothIndex: 0,
+    maskWidth: 0,
+    maskHeight: 0,
+    hasMask: false,
+    interval: 2,
+    frameCount: 0,
+    lastTimestamp: 0,
+    onFrame: null,
+};
+
+function initLiveGL(width, height) {
+    const { canvas, gl } = createHudGLCanvas(width, height);
+    liveCutout.canvas = canvas;
+    liveCutout.gl = gl;
+    liveCutout.programs = {
+        blend: compileHudProgram(gl, BLEND_SHADER),
+        composite: compileHudProgram(gl, COMPOSITE_SHADER),
+    };
+    liveCutout.videoTex = createHudTexture(gl);
+    liveCutout.maskTex = createHudTexture(gl);
+}
+
+// 마스크 크기가 정해지면 평활 마스크 핑퐁 버퍼를 만든다
+function ensureSmoothTargets(width, height) {
+    const lc = liveCutout;
+    if (lc.maskWidth === width && lc.maskHeight === height) return;
+    const gl = lc.gl;
+    for (let i = 0; i < 2; i++) {
+        if (lc.smoothTex[i]) gl.deleteTexture(lc.smoothTex[i]);
+        if (lc.smoothFbo[i]) gl.deleteFramebuffer(lc.smoothFbo[i]);
+        lc.smoothTex[i] = createHudTexture(gl);
+        gl.texImage2D(gl.TEXTURE_2D, 0, gl.RGBA, width, height, 0, gl.RGBA, gl.UNSIGNED_BYTE, null);
+        lc.smoothFbo[i] = gl.createFramebuffer();
+        gl.bindFramebuffer(gl.FRAMEBUFFER, lc.smoothFbo[i]);
+        gl.framebufferTexture2D(gl.FRAMEBUFFER, gl.COLOR_ATTACHMENT0, gl.TEXTURE_2D, lc.smoothTex[i], 0);
+    }
+    gl.bindFramebuffer(gl.FRAMEBUFFER, null);
+    lc.maskWidth = width;
+    lc.maskHeight = height;
+    lc.hasMask = false;
+}
+
+// 새 마스크(Uint8, 0..255)를 올리고 이전 평활 마스크와 섞는다
+function blendMask(mask, width, height) {
+    const lc = liveCutout;
+    const gl = lc.gl;
+    ensureSmoothTargets(width, height);
+
+    gl.activeTexture(gl.TEXTURE0);
+    gl.bindTexture(gl.TEXTURE_2D, lc.maskTex);
+    gl.texImage2D(gl.TEXTURE_2D, 0, gl.LUMINANCE, width, height, 0, gl.LUMINANCE, gl.UNSIGNED_BYTE, mask);
+
+    const src = lc.smoothIndex;
+    const dst = 1 - src;
+    const prog = lc.programs.blend;
+    gl.useProgram(prog);
+    gl.activeTexture(gl.TEXTURE1);
+    gl.bindTexture(gl.TEXTURE_2D, lc.smoothTex[src]);
+    gl.uniform1i(gl.getUniformLocation(prog, 'u_mask'), 0);
+    gl.uniform1i(gl.getUniformLocation(prog, 'u_prev'), 1);
+    gl.uniform2f(gl.getUniformLocation(prog, 'u_size'), width, height);
+    gl.uniform1f(gl.getUniformLocation(prog, 'u_blend'), lc.hasMask ? LIVE_CUTOUT.maskBlend : 1.0);
+    gl.bindFramebuffer(gl.FRAMEBUFFER, lc.smoothFbo[dst]);
+    gl.viewport(0, 0, width, height);
+    gl.drawArrays(gl.TRIANGLE_STRIP, 0, 4);
+    gl.bindFramebuffer(gl.FRAMEBUFFER, null);
+
+    lc.smoothIndex = dst;
+    lc.hasMask = true;
+}
+
+function drawCutout() {
+    const lc = liveCutout;
+    const gl = lc.gl;
+    gl.viewport(0, 0, lc.canvas.width, lc.canvas.height);
+    gl.clearColor(0, 0, 0, 0);
+    gl.clear(gl.COLOR_BUFFER_BIT);
+    if (!lc.hasMask) return;
+
+    const prog = lc.programs.composite;
+    gl.useProgram(prog);
+    gl.activeTexture(gl.TEXTURE0);
+    uploadVideoTexture(gl, lc.videoTex, lc.source);
+    gl.activeTexture(gl.TEXTURE1);
+    gl.bindTexture(gl.TEXTURE_2D, lc.smoothTex[lc.smoothIndex]);
+    gl.uniform1i(gl.getUniformLocation(prog, 'u_video'), 0);
+    gl.uniform1i(gl.getUniformLocation(prog, 'u_mask'), 1);
+    gl.uniform1f(gl.getUniformLocation(prog, 'u_mirror'), lc.mirror ? 1 : 0);
+    gl.uniform2f(gl.getUniformLocation(prog, 'u_edge'), LIVE_CUTOUT.edge[0], LIVE_CUTOUT.edge[1]);
+    gl.drawArrays(gl.TRIANGLE_STRIP, 0, 4);
+}
+
+function segmentFrame(timestamp) {
+    const lc = liveCutout;
+    const t0 = performance.now();
+    lc.segmenter.segmentForVideo(lc.source, timestamp, (result) => {
+        const mask = result.confidenceMasks && result.confidenceMasks[0];
+        if (mask) blendMask(mask.getAsUint8Array(), mask.width, mask.height);
+    });
+    const elapsed = performance.now() - t0;
+    FrameStats.record('segmentationMs', elapsed);
+    // 분할 비용을 간격으로 나눈 값이 예산 안에 들도록 간격을 조정한다
+    lc.interval = Math.max(1, Math.min(LIVE_CUTOUT.maxInterval, Math.ceil(elapsed / LIVE_CUTOUT.budgetMs)));
+}
+
+function onSourceFrame(now, metadata) {
+    const lc = liveCutout;
+    if (!lc.source) return;
+    lc.source.requestVideoFrameCallback(onSourceFrame);
+    if (lc.frameCount % lc.interval === 0) {
+        // segmentForVideo 는 타임스탬프가 계속 커져야 한다. 클립이 반복되면 mediaTime 은 0 으로 돌아가므로
+        // rVFC 의 now(문서 시계)를 쓰고, 같은 값이 오면 1ms 올린다.
+        lc.lastTimestamp = Math.max(now, lc.lastTimestamp + 1);
+        try {
+            segmentFrame(lc.lastTimestamp);
+        } catch (e) {
+            console.warn('[AR] 실시간 분할 실패:', e);
+        }
+    }
+    lc.frameCount++;
+    drawCutout();
+    if (lc.onFrame) lc.onFrame();
+}
+
+async function openLiveSource(spec, mainFacing) {
+    const source = document.createElement('video');
+    source.muted = true;
+    source.playsInline = true;
+    source.setAttribute('playsinline', '');
+    if (spec === 'camera') {
+        // 반대쪽 카메라 (보통 전면 셀피 카메라). 카메라를 하나만 열 수 있는 기기에서는 실패한다.
+        const facing = mainFacing === 'environment' ? 'user' : 'environment';
+        liveCutout.stream = await navigator.mediaDevices.getUserMedia({ video: pickCameraConstraints(facing) });
+        liveCutout.mirror = facing === 'user';
+        source.srcObject = liveCutout.stream;
+    } else {
+        source.crossOrigin = 'anonymous';
+        source.loop = true;
+        source.src = spec;
+    }
+    await source.play();
+    if (!source.videoWidth) await new Promise((resolve) => source.addEventListener('loadedmetadata', resolve, { once: true }));
+    return source;
+}
+
+async function createSegmenter() {
+    const vision = await import(LIVE_CUTOUT.libraryUrl);
+    const fileset = await vision.FilesetResolver.forVisionTasks(LIVE_CUTOUT.wasmRoot);
+    const options = (delegate) => ({
+        baseOptions: { modelAssetPath: LIVE_CUTOUT.modelUrl, delegate },
+        runningMode: 'VIDEO',
+        outputCategoryMask: false,
+        outputConfidenceMasks: true,
+    });
+    try {
+        return { segmenter: await vision.ImageSegmenter.createFromOptions(fileset, options('GPU')), delegate: 'GPU' };
+    } catch (e) {
+        console.warn('[AR] GPU 분할 초기화 실패, Wasm(CPU)로 전환:', e);
+        return { segmenter: await vision.ImageSegmenter.createFromOptions(fileset, options('CPU')), delegate: 'CPU' };
+    }
+}
+
+// 실시간 컷아웃 시작. 결과 캔버스를 HUD 소스로 쓴다.
+async function startLiveCutout(spec, mainFacing, onFrame) {
+    const [source, seg] = await Promise.all([openLiveSource(spec, mainFacing), createSegmenter()]);
+    if (typeof source.requestVideoFrameCallback !== 'function') throw new Error('requestVideoFrameCallback 미지원');
+
+    const size = fitLongSide(source.videoWidth, source.videoHeight, LIVE_CUTOUT.maxSide);
+    initLiveGL(size.width, size.height);
+    liveCutout.source = source;
+    liveCutout.segmenter = seg.segmenter;
+    liveCutout.onFrame = onFrame;
+    source.requestVideoFrameCallback(onSourceFrame);
+    console.log('[AR] 실시간 컷아웃 시작:', spec, source.videoWidth + 'x' + source.videoHeight, '분할:', seg.delegate);
+    return liveCutout.canvas;
+}
+
+// 화면을 떠나 있는 동안 소스와 분할을 멈춘다 (카메라 스트림은 닫지 않고 트랙만 끈다)
+function pauseLiveCutout() {
+    const lc = liveCutout;
+    if (!lc.source) return;
+    lc.source.pause();
+    if (lc.stream) lc.stream.getVideoTracks().forEach((t) => { t.enabled = false; });
+}
+
+function resumeLiveCutout() {
+    const lc = liveCutout;
+    if (!lc.source) return Promise.resolve();
+    if (lc.stream) lc.stream.getVideoTracks().forEach((t) => { t.enabled = true; });
+    return lc.source.play();
+}
+
+function stopLiveCutout() {
+    const lc = liveCutout;
+    if (lc.stream) lc.stream.getTracks().forEach((t) => t.stop());
+    if (lc.source) lc.source.pause();
+    if (lc.segmenter) lc.segmenter.close();
+    lc.source = null;
+    lc.stream = null;
+    lc.segmenter = null;
+}
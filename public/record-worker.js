@@ -0,0 +1,278 @@
+// 녹화 워커: 메인 스레드가 합성한 VideoFrame 을 WebCodecs VideoEncoder(H.264, 하드웨어 우선)로 인코딩하고
+// 조각난 MP4(fMP4) 로 묶어 키프레임 단위로 메인 스레드에 넘긴다.
+// 인코더 큐가 밀리면 프레임을 버려서 메인 스레드(미리보기)가 기다리지 않게 한다.
+
+// 720p30 에서 하드웨어 인코더가 보통 지원하는 프로필 순서 (Main 3.1 -> Baseline 3.1)
+const AVC_CODECS = ['avc1.4d401f', 'avc1.42e01f', 'avc1.42001f'];
+const MP4_TIMESCALE = 90000;
+const MAX_ENCODE_QUEUE = 2;
+
+let encoder = null;
+let muxer = null;
+let frameIndex = 0;
+let keyInterval = 60;
+let dropped = 0;
+
+// === MP4 박스 ===
+function box(type, ...payloads) {
+    let size = 8;
+    for (const p of payloads) size += p.byteLength;
+    const out = new Uint8Array(size);
+    const view = new DataView(out.buffer);
+    view.setUint32(0, size);
+    for (let i = 0; i < 4; i++) out[4 + i] = type.charCodeAt(i);
+    let offset = 8;
+    for (const p of payloads) {
+        out.set(p, offset);
+        offset += p.byteLength;
+    }
+    return out;
+}
+
+function fullBox(type, version, flags, ...payloads) {
+    return box(type, u8([version, flags >> 16 & 255, flags >> 8 & 255, flags & 255]), ...payloads);
+}
+
+function u8(values) {
+    return new Uint8Array(values);
+}
+
+function u16(...values) {
+    const out = new Uint8Array(values.length * 2);
+    const view = new DataView(out.buffer);
+    values.forEach((v, i) => view.setUint16(i * 2, v));
+    return out;
+}
+
+function u32(...values) {
+    const out = new Uint8Array(values.length * 4);
+    const view = new DataView(out.buffer);
+    values.forEach((v, i) => view.setUint32(i * 4, v >>> 0));
+    return out;
+}
+
+function u64(value) {
+    return u32(Math.floor(value / 0x100000000), value % 0x100000000);
+}
+
+function ascii(text) {
+    return u8(Array.from(text, (c) => c.charCodeAt(0)));
+}
+
+const UNITY_MATRIX = u32(0x00010000, 0, 0, 0, 0x00010000, 0, 0, 0, 0x40000000);
+
+// ftyp + moov (샘플 없는 트랙 하나, 샘플은 전부 moof/mdat 조각으로 온다)
+function initSegment(width, height, avcC) {
+    const ftyp = box('ftyp', ascii('isom'), u32(0x200), ascii('isomiso6avc1mp41'));
+    const mvhd = fullBox('mvhd', 0, 0,
+        u32(0, 0, 1000, 0), u32(0x00010000), u16(0x0100), new Uint8Array(10), UNITY_MATRIX,
+        new Uint8Array(24), u32(2));
+    const tkhd = fullBox('tkhd', 0, 3,
+        u32(0, 0, 1, 0, 0), new Uint8Array(8), u16(0, 0, 0, 0), UNITY_MATRIX,
+        u32(width << 16, height << 16));
+    // language 'und'
+    const mdhd = fullBox('mdhd', 0, 0, u32(0, 0, MP4_TIMESCALE, 0), u16(0x55c4, 0));
+    const hdlr = fullBox('hdlr', 0, 0, u32(0), ascii('vide'), u32(0, 0, 0), ascii('VideoHandler\0'));
+    const avc1 = box('avc1',
+        new Uint8Array(6), u16(1), new Uint8Array(16), u16(width, height),
+        u32(0x00480000, 0x00480000, 0), u16(1), new Uint8Array(32), u16(0x0018, 0xffff),
+        box('avcC', avcC));
+    const stbl = box('stbl',
+        fullBox('stsd', 0, 0, u32(1), avc1),
+        fullBox('stts', 0, 0, u32(0)),
+        fullBox('stsc', 0, 0, u32(0)),
+        fullBox('stsz', 0, 0, u32(0, 0)),
+        fullBox('stco', 0, 0, u32(0)));
+    const minf = box('minf',
+        fullBox('vmhd', 0, 1, u16(0, 0, 0, 0)),
+        box('dinf', fullBox('dref', 0, 0, u32(1), fullBox('url ', 0, 1))),
+        stbl);
+    const trak = box('trak', tkhd, box('mdia', mdhd, hdlr, minf));
+    const mvex = box('mvex', fullBox('trex', 0, 0, u32(1, 1, 0, 0, 0)));
+    const moov = box('moov', mvhd, trak, mvex);
+    return concat([ftyp, moov]);
+}
+
+// moof + mdat 한 조각. samples: [{ data, duration, key }]
+function mediaSegment(sequence, baseTime, samples) {
+    const count = samples.length;
+    const trunFlags = 0x000001 | 0x000100 | 0x000200 | 0x000400;
+    const entries = new Uint8Array(count * 12);
+    const view = new DataView(entries.buffer);
+    let mdatSize = 8;
+    samples.forEach((s, i) => {
+        view.setUint32(i * 12, s.duration);
+        view.setUint32(i * 12 + 4, s.data.byteLength);
+        // 키프레임: sample_depends_on=2, 나머지: depends_on=1 + non-sync
+        view.setUint32(i * 12 + 8, s.key ? 0x02000000 : 0x01010000);
+        mdatSize += s.data.byteLength;
+    });
+    // data_offset 은 moof 시작에서 mdat 페이로드까지 거리라 moof 크기를 먼저 알아야 한다
+    const build = (dataOffset) => box('moof',
+        fullBox('mfhd', 0, 0, u32(sequence)),
+        box('traf',
+            fullBox('tfhd', 0, 0x020000, u32(1)),
+            fullBox('tfdt', 1, 0, u64(baseTime)),
+            fullBox('trun', 0, trunFlags, u32(count, dataOffset), entries)));
+    const moofSize = build(0).byteLength;
+    const moof = build(moofSize + 8);
+    const mdatHeader = u32(mdatSize, 0x6d646174);
+    return concat([moof, mdatHeader, ...samples.map((s) => s.data)]);
+}
+
+function concat(parts) {
+    let size = 0;
+    for (const p of parts) size += p.byteLength;
+    const out = new Uint8Array(size);
+    let offset = 0;
+    for (const p of parts) {
+        out.set(p, offset);
+        offset += p.byteLength;
+    }
+    return out;
+}
+
+// === fMP4 멀티플렉서 ===
+// 키프레임이 올 때마다 쌓인 샘플을 조각 하나로 내보낸다. 샘플 길이는 다음 샘플 시각으로 정한다.
+function createMuxer(width, height) {
+    let header = null;
+    let pending = [];
+    let sequence = 1;
+    let baseTime = 0;
+    let lastDuration = Math.round(MP4_TIMESCALE / 30);
+
+    const emit = (bytes) => self.postMessage({ type: 'data', bytes: bytes.buffer }, [bytes.buffer]);
+
+    const flush = (nextTime) => {
+        if (pending.length === 0) return;
+        const samples = pending.map((s, i) => {
+            const next = i + 1 < pending.length ? pending[i + 1].time : nextTime;
+            const duration = next !== undefined ? Math.max(1, next - s.time) : lastDuration;
+            lastDuration = duration;
+            return { data: s.data, duration, key: s.key };
+        });
+        emit(mediaSegment(sequence++, baseTime, samples));
+        baseTime = nextTime !== undefined ? nextTime : pending[pending.length - 1].time + lastDuration;
+        pending = [];
+    };
+
+    return {
+        addChunk(chunk, metadata) {
+            if (!header) {
+                const description = metadata && metadata.decoderConfig && metadata.decoderConfig.description;
+                if (!description) return;
+                header = ArrayBuffer.isView(description)
+                    ? new Uint8Array(description.buffer, description.byteOffset, description.byteLength).slice()
+                    : new Uint8Array(description);
+                emit(initSegment(width, height, header));
+            }
+            const data = new Uint8Array(chunk.byteLength);
+            chunk.copyTo(data);
+            const time = Math.round(chunk.timestamp * MP4_TIMESCALE / 1e6);
+            const key = chunk.type === 'key';
+            if (pending.length === 0) {
+                // 첫 조각은 반드시 키프레임으로 시작한다
+                if (!key) return;
+                baseTime = time;
+            } else if (key) {
+                flush(time);
+            }
+            pending.push({ data, time, key });
+        },
+        finish() {
+            flush(undefined);
+        },
+    };
+}
+
+// === 인코더 ===
+async function pickEncoderConfig(msg) {
+    for (const codec of AVC_CODECS) {
+        for (const hardwareAcceleration of ['prefer-hardware', 'no-preference']) {
+            const config = {
+                codec,
+                width: msg.width,
+                height: msg.height,
+                bitrate: msg.bitrate,
+                framerate: msg.fps,
+                hardwareAcceleration,
+                latencyMode: 'realtime',
+                avc: { format: 'avc' },
+            };
+            try {
+                const support = await VideoEncoder.isConfigSupported(config);
+                if (support.supported) return support.config || config;
+            } catch (e) {
+                // 이 조합은 건너뛴다
+            }
+        }
+    }
+    return null;
+}
+
+async function start(msg) {
+    if (typeof VideoEncoder === 'undefined') {
+        self.postMessage({ type: 'unsupported' });
+        return;
+    }
+    const config = await pickEncoderConfig(msg);
+    if (!config) {
+        self.postMessage({ type: 'unsupported' });
+        return;
+    }
+    muxer = createMuxer(msg.width, msg.height);
+    frameIndex = 0;
+    dropped = 0;
+    keyInterval = Math.max(1, Math.round(msg.fps * msg.keyIntervalSec));
+    encoder = new VideoEncoder({
+        output: (chunk, metadata) => muxer.addChunk(chunk, metadata),
+        error: (e) => self.postMessage({ type: 'error', message: e.message }),
+    });
+    encoder.configure(config);
+    self.postMessage({ type: 'started', codec: config.codec, hardwareAcceleration: config.hardwareAcceleration });
+}
+
+function encodeFrame(frame) {
+    if (!encoder || encoder.state !== 'configured') {
+        frame.close();
+        return;
+    }
+    const keyFrame = frameIndex % keyInterval === 0;
+    // 인코더가 밀리면 키프레임이 아닌 프레임은 버린다
+    if (!keyFrame && encoder.encodeQueueSize > MAX_ENCODE_QUEUE) {
+        dropped++;
+        frame.close();
+        return;
+    }
+    frameIndex++;
+    try {
+        encoder.encode(frame, { keyFrame });
+    } finally {
+        frame.close();
+    }
+}
+
+async function stop() {
+    if (!encoder) return;
+    try {
+        if (encoder.state === 'configured') await encoder.flush();
+        muxer.finish();
+    } finally {
+        if (encoder.state !== 'closed') encoder.close();
+        encoder = null;
+        muxer = null;
+    }
+    self.postMessage({ type: 'done', frames: frameIndex, dropped });
+}
+
+self.onmessage = async (e) => {
+    const msg = e.data;
+    try {
+        if (msg.type === 'start') await start(msg);
+        else if (msg.type === 'frame') encodeFrame(msg.frame);
+        else if (msg.type === 'stop') await stop();
+    } catch (err) {
+        if (msg.frame) msg.frame.close();
+        self.postMessage({ type: 'error', message: err && err.message ? err.message : String(err) });
+    }
+};
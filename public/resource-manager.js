@@ -0,0 +1,166 @@
+// Blob / object URL / ImageBitmap 수명 관리 (index.html / ar.html 공용)
+// 자원은 이름 붙은 슬롯에 담고, 같은 슬롯에 새 자원을 담으면 이전 것을 바로 해제한다.
+// URL 은 revoke, 비트맵은 close, Blob 은 참조를 끊는다. 슬롯별 보유 바이트는 FrameStats 게이지로 보고한다.
+
+(function(global) {
+    // 슬롯 이름 -> [{ kind, bytes, dispose }]
+    var slots = new Map();
+    var retained = 0;
+
+    function report() {
+        if (typeof FrameStats !== 'undefined' && FrameStats.gauge) FrameStats.gauge('retainedBytes', retained);
+    }
+
+    // 슬롯에 자원을 더한다 (기존 자원은 그대로 둔다)
+    function add(slot, kind, bytes, dispose) {
+        var list = slots.get(slot);
+        if (!list) {
+            list = [];
+            slots.set(slot, list);
+        }
+        list.push({ kind: kind, bytes: bytes || 0, dispose: dispose });
+        retained += bytes || 0;
+        report();
+    }
+
+    function release(slot) {
+        var list = slots.get(slot);
+        if (!list) return;
+        slots.delete(slot);
+        for (var i = 0; i < list.length; i++) {
+            retained -= list[i].bytes;
+            try {
+                if (list[i].dispose) list[i].dispose();
+            } catch (e) {
+                console.warn('[Resources] 해제 실패:', slot, e);
+            }
+        }
+        report();
+    }
+
+    function releaseAll() {
+        Array.from(slots.keys()).forEach(release);
+    }
+
+    // 슬롯의 이전 자원을 해제하고 새 자원을 담는다
+    function hold(slot, kind, bytes, dispose) {
+        release(slot);
+        add(slot, kind, bytes, dispose);
+    }
+
+    function bitmapBytes(bitmap) {
+        return (bitmap.width || 0) * (bitmap.height || 0) * 4;
+    }
+
+    function holdBlob(slot, blob) {
+        hold(slot, 'blob', blob.size, null);
+        return blob;
+    }
+
+    function holdBitmap(slot, bitmap) {
+        hold(slot, 'bitmap', bitmapBytes(bitmap), function() { if (bitmap.close) bitmap.close(); });
+        return bitmap;
+    }
+
+    function addBitmap(slot, bitmap) {
+        add(slot, 'bitmap', bitmapBytes(bitmap), function() { if (bitmap.close) bitmap.close(); });
+        return bitmap;
+    }
+
+    // object URL 은 원본 Blob 을 붙잡아 두므로 Blob 크기를 그대로 센다
+    function addObjectURL(slot, blob) {
+        var url = URL.createObjectURL(blob);
+        add(slot, 'url', blob.size, function() { URL.revokeObjectURL(url); });
+        return url;
+    }
+
+    function holdObjectURL(slot, blob) {
+        release(slot);
+        return addObjectURL(slot, blob);
+    }
+
+    // createImageBitmap 리사이즈 옵션이 없는 브라우저용: 디코드 후 바로 줄여 그리고 URL 을 해제한다
+    function decodeWithImage(blob, width) {
+        return new Promise(function(resolve, reject) {
+            var url = URL.createObjectURL(blob);
+            var img = new Image();
+            img.onload = function() {
+                URL.revokeObjectURL(url);
+                var canvas = document.createElement('canvas');
+                canvas.width = width;
+                canvas.height = Math.max(1, Math.round(width * img.naturalHeight / img.naturalWidth));
+                canvas.getContext('2d').drawImage(img, 0, 0, canvas.width, canvas.height);
+                resolve(canvas);
+            };
+            img.onerror = function() {
+                URL.revokeObjectURL(url);
+                reject(new Error('이미지 디코드 실패'));
+            };
+            img.src = url;
+        });
+    }
+
+    async function decodeDownscaled(blob, width) {
+        if (typeof createImageBitmap === 'function') {
+            try {
+                return await createImageBitmap(blob, { resizeWidth: width, resizeQuality: 'medium' });
+            } catch (e) {
+                // 리사이즈 옵션 미지원
+            }
+        }
+        return decodeWithImage(blob, width);
+    }
+
+    // 줄인 비트맵을 캔버스에 넘겨 미리보기로 쓴다 (data URL / 원본 해상도 보관 없음).
+    // 'bitmaprenderer' 는 비트맵을 복사하지 않고 캔버스로 옮긴다.
+    async function renderPreview(slot, canvas, blob, maxWidth) {
+        var source = await decodeDownscaled(blob, Math.max(1, Math.round(maxWidth)));
+        release(slot);
+        canvas.width = source.width;
+        canvas.height = source.height;
+        var bytes = bitmapBytes(source);
+        var ctx = source.close ? canvas.getContext('bitmaprenderer') : null;
+        if (ctx) {
+            ctx.transferFromImageBitmap(source);
+        } else {
+            var ctx2d = canvas.getContext('2d');
+            if (ctx2d) ctx2d.drawImage(source, 0, 0);
+            if (source.close) source.close();
+        }
+        add(slot, 'preview', bytes, function() {
+            canvas.width = 0;
+            canvas.height = 0;
+        });
+        return canvas;
+    }
+
+    function retainedBytes() {
+        return retained;
+    }
+
+    // 슬롯별 보유량 (콘솔 진단용)
+    function snapshot() {
+        var out = {};
+        slots.forEach(function(list, slot) {
+            var bytes = 0;
+            for (var i = 0; i < list.length; i++) bytes += list[i].bytes;
+            out[slot] = { count: list.length, bytes: bytes };
+        });
+        return { retainedBytes: retained, slots: out };
+    }
+
+    global.Resources = {
+        add: add,
+        hold: hold,
+        release: release,
+        releaseAll: releaseAll,
+        holdBlob: holdBlob,
+        holdBitmap: holdBitmap,
+        addBitmap: addBitmap,
+        addObjectURL: addObjectURL,
+        holdObjectURL: holdObjectURL,
+        renderPreview: renderPreview,
+        retainedBytes: retainedBytes,
+        snapshot: snapshot
+    };
+})(self);
@@ -0,0 +1,182 @@
+// 화면 라우터 (index.html 에서 사용)
+// 업로드 화면과 AR 화면을 한 문서에 두고 보이는 쪽만 바꾼다. 페이지를 다시 열지 않으므로
+// 배경 제거 모델, Wasm 인스턴스, 카메라 스트림이 화면을 오가도 그대로 남는다.
+// AR 화면은 처음 들어갈 때 ar.html 을 받아 마크업/스타일/스크립트를 이 문서에 붙인다 (이미 있는 스크립트는 건너뛴다).
+// 두 화면의 스타일은 서로 겹치므로 지금 화면의 <style> 만 켜 둔다.
+// 주소는 실제 파일(index.html / ar.html)로 바꿔서 새로고침하면 각 페이지가 단독으로 열린다.
+// 화면은 onEnter / onLeave 에 일시정지·재개 처리를 건다.
+
+(function(global) {
+    var VIEW_URLS = {
+        upload: 'index.html',
+        ar: 'ar.html'
+    };
+
+    var views = {};      // 이름 -> { root, styles, title, viewport }
+    var hooks = { enter: {}, leave: {} };
+    var current = null;
+    var mounting = null;
+    var pushedDepth = 0;
+
+    function viewportMeta() {
+        return document.querySelector('meta[name="viewport"]');
+    }
+
+    // 처음 문서(index.html)의 내용을 업로드 화면으로 묶는다
+    function adoptInitialView(name) {
+        var root = document.createElement('div');
+        root.dataset.view = name;
+        Array.prototype.slice.call(document.body.childNodes).forEach(function(node) {
+            if (node.nodeName !== 'SCRIPT') root.appendChild(node);
+        });
+        document.body.insertBefore(root, document.body.firstChild);
+        views[name] = {
+            root: root,
+            styles: Array.prototype.slice.call(document.head.querySelectorAll('style, link[rel="stylesheet"]')),
+            title: document.title,
+            viewport: viewportMeta() ? viewportMeta().content : null
+        };
+        current = name;
+    }
+
+    function loadScript(src) {
+        return new Promise(function(resolve, reject) {
+            var script = document.createElement('script');
+            script.src = src;
+            script.async = false;
+            script.onload = resolve;
+            script.onerror = function() { reject(new Error('스크립트 로드 실패: ' + src)); };
+            document.body.appendChild(script);
+        });
+    }
+
+    // 다른 페이지를 받아 화면으로 붙인다. 스크립트는 문서 순서대로 하나씩 실행한다.
+    async function mountView(name) {
+        var t0 = performance.now();
+        var url = new URL(VIEW_URLS[name], location.href).href;
+        var response = await fetch(url);
+        if (!response.ok) throw new Error('화면 로드 실패: ' + response.status);
+        var doc = new DOMParser().parseFromString(await response.text(), 'text/html');
+
+        var styles = Array.prototype.slice.call(doc.head.querySelectorAll('style')).map(function(style) {
+            var copy = document.createElement('style');
+            copy.textContent = style.textContent;
+            copy.disabled = true;
+            document.head.appendChild(copy);
+            // 붙인 뒤에 다시 꺼야 시트가 적용되지 않는다
+            copy.disabled = true;
+            return copy;
+        });
+
+        var root = document.createElement('div');
+        root.dataset.view = name;
+        root.hidden = true;
+        Array.prototype.slice.call(doc.body.childNodes).forEach(function(node) {
+            if (node.nodeName !== 'SCRIPT') root.appendChild(document.importNode(node, true));
+        });
+        document.body.appendChild(root);
+
+        var meta = doc.querySelector('meta[name="viewport"]');
+        views[name] = {
+            root: root,
+            styles: styles,
+            title: doc.title,
+            viewport: meta ? meta.content : null
+        };
+
+        var loaded = {};
+        Array.prototype.forEach.call(document.scripts, function(s) { if (s.src) loaded[s.src] = true; });
+        var scripts = Array.prototype.slice.call(doc.querySelectorAll('script[src]'));
+        for (var i = 0; i < scripts.length; i++) {
+            var src = new URL(scripts[i].getAttribute('src'), url).href;
+            if (loaded[src]) continue;
+            loaded[src] = true;
+            await loadScript(src);
+        }
+        console.log('[Router] 화면 붙임:', name, (performance.now() - t0).toFixed(0) + 'ms');
+    }
+
+    function ensureView(name) {
+        if (views[name]) return Promise.resolve();
+        if (!mounting) {
+            mounting = mountView(name).then(function() {
+                mounting = null;
+            }, function(err) {
+                mounting = null;
+                throw err;
+            });
+        }
+        return mounting;
+    }
+
+    function runHooks(kind, name) {
+        (hooks[kind][name] || []).forEach(function(fn) {
+            try {
+                fn();
+            } catch (e) {
+                console.error('[Router] ' + kind + ' 처리 실패:', name, e);
+            }
+        });
+    }
+
+    function activate(name) {
+        Object.keys(views).forEach(function(key) {
+            var view = views[key];
+            var active = key === name;
+            view.root.hidden = !active;
+            view.styles.forEach(function(style) { style.disabled = !active; });
+        });
+        var view = views[name];
+        document.title = view.title;
+        if (view.viewport && viewportMeta()) viewportMeta().content = view.viewport;
+        window.scrollTo(0, 0);
+    }
+
+    async function show(name, push) {
+        if (name === current) return;
+        await ensureView(name);
+        var previous = current;
+        if (previous) runHooks('leave', previous);
+        activate(name);
+        current = name;
+        if (push) {
+            history.pushState({ view: name }, '', VIEW_URLS[name] + location.search);
+            pushedDepth++;
+        }
+        runHooks('enter', name);
+    }
+
+    function on(kind, name, fn) {
+        if (!hooks[kind][name]) hooks[kind][name] = [];
+        hooks[kind][name].push(fn);
+    }
+
+    window.addEventListener('popstate', function(e) {
+        var name = e.state && e.state.view;
+        if (!name || !VIEW_URLS[name]) return;
+        if (pushedDepth > 0) pushedDepth--;
+        show(name, false).catch(function(err) {
+            console.error('[Router] 화면 전환 실패:', err);
+            location.reload();
+        });
+    });
+
+    adoptInitialView('upload');
+    history.replaceState({ view: 'upload' }, '');
+
+    global.AppRouter = {
+        // 새 기록을 남기고 화면을 바꾼다
+        navigate: function(name) { return show(name, true); },
+        // navigate 로 들어온 화면이면 기록을 되돌리고, 아니면 fallback 으로 이동한다
+        back: function(fallback) {
+            if (pushedDepth > 0) {
+                history.back();
+                return Promise.resolve();
+            }
+            return show(fallback, true);
+        },
+        current: function() { return current; },
+        onEnter: function(name, fn) { on('enter', name, fn); },
+        onLeave: function(name, fn) { on('leave', name, fn); }
+    };
+})(window);
@@ -0,0 +1,147 @@
+// 자이로 센서 융합 (시각 추적 폴백)
+// devicemotion 의 각속도를 적분하고 deviceorientation 으로 드리프트를 잡는 상보 필터.
+// 결과는 앵커 시점 이후의 장치 회전(장치 좌표계 x/y/z 축 라디안)이다.
+// 상태는 미리 잡아 둔 Float32Array 에만 쓰고 이벤트 처리 중에는 객체를 만들지 않는다.
+// 타임스탬프만은 float32 로는 몇 시간 뒤(또는 epoch 기준 WebView 에서) 간격이 뭉개지므로 일반 number 로 둔다.
+
+// 자이로 적분값 비중 (나머지는 orientation 기준 회전으로 보정)
+const FUSION_GYRO_WEIGHT = 0.98;
+// 카메라 긴 변 화각 (대략값)
+const CAMERA_LONG_FOV = 66 * Math.PI / 180;
+const DEG_TO_RAD = Math.PI / 180;
+
+// fusionState 인덱스
+const FUSION_RX = 0;        // 앵커 이후 회전 (장치 x/y/z 축)
+const FUSION_RY = 1;
+const FUSION_RZ = 2;
+const FUSION_HAS_REF = 3;   // 앵커 시점 orientation 을 받았는지
+const fusionState = new Float32Array(4);
+// 앵커 시점 / 현재 orientation 회전 행렬 (장치 -> 지구, 행 우선)
+const fusionRef = new Float32Array(9);
+const fusionCur = new Float32Array(9);
+
+let fusionLastMotionT = 0;   // 마지막 devicemotion timeStamp (ms)
+let fusionListening = false;
+let fusionHasMotion = false;
+let fusionOnUpdate = null;
+let motionPermission = null;
+
+// iOS 13+ 는 사용자 제스처 안에서 권한을 요청해야 한다 (탭 핸들러에서 바로 호출)
+function requestMotionPermission() {
+    if (!motionPermission) {
+        const D = typeof DeviceMotionEvent !== 'undefined' ? DeviceMotionEvent : null;
+        motionPermission = D && typeof D.requestPermission === 'function'
+            ? D.requestPermission().then((state) => state === 'granted').catch(() => false)
+            : Promise.resolve(typeof DeviceMotionEvent !== 'undefined');
+    }
+    return motionPermission;
+}
+
+// W3C Device Orientation 의 ZXY 오일러 각 -> 회전 행렬
+function orientationMatrix(alpha, beta, gamma, out) {
+    const a = alpha * DEG_TO_RAD, b = beta * DEG_TO_RAD, g = gamma * DEG_TO_RAD;
+    const cA = Math.cos(a), sA = Math.sin(a);
+    const cB = Math.cos(b), sB = Math.sin(b);
+    const cG = Math.cos(g), sG = Math.sin(g);
+    out[0] = cA * cG - sA * sB * sG; out[1] = -cB * sA; out[2] = cG * sA * sB + cA * sG;
+    out[3] = cG * sA + cA * sB * sG; out[4] = cA * cB;  out[5] = sA * sG - cA * cG * sB;
+    out[6] = -cB * sG;               out[7] = sB;       out[8] = cB * cG;
+}
+
+function onDeviceMotion(e) {
+    const rate = e.rotationRate;
+    if (!rate || rate.alpha === null) return;
+    const t = e.timeStamp;
+    const last = fusionLastMotionT;
+    fusionLastMotionT = t;
+    fusionHasMotion = true;
+    if (last === 0) return;
+    const dt = Math.min(0.1, (t - last) / 1000);
+    // rotationRate: alpha = z, beta = x, gamma = y (deg/s, 장치 좌표계)
+    fusionState[FUSION_RX] += rate.beta * DEG_TO_RAD * dt;
+    fusionState[FUSION_RY] += rate.gamma * DEG_TO_RAD * dt;
+    fusionState[FUSION_RZ] += rate.alpha * DEG_TO_RAD * dt;
+    if (fusionOnUpdate) fusionOnUpdate();
+}
+
+function onDeviceOrientation(e) {
+    if (e.alpha === null || e.beta === null || e.gamma === null) return;
+    if (!fusionState[FUSION_HAS_REF]) {
+        orientationMatrix(e.alpha, e.beta, e.gamma, fusionRef);
+        fusionState[FUSION_HAS_REF] = 1;
+        return;
+    }
+    orientationMatrix(e.alpha, e.beta, e.gamma, fusionCur);
+    // 앵커 장치 좌표계에서 본 상대 회전 Rref^T * Rcur 의 작은 각 회전 벡터
+    const r = fusionRef, c = fusionCur;
+    const m01 = r[0] * c[1] + r[3] * c[4] + r[6] * c[7];
+    const m02 = r[0] * c[2] + r[3] * c[5] + r[6] * c[8];
+    const m10 = r[1] * c[0] + r[4] * c[3] + r[7] * c[6];
+    const m12 = r[1] * c[2] + r[4] * c[5] + r[7] * c[8];
+    const m20 = r[2] * c[0] + r[5] * c[3] + r[8] * c[6];
+    const m21 = r[2] * c[1] + r[5] * c[4] + r[8] * c[7];
+    const ox = 0.5 * (m21 - m12);
+    const oy = 0.5 * (m02 - m20);
+    const oz = 0.5 * (m10 - m01);
+
+    if (!fusionHasMotion) {
+        // 자이로가 없는 기기는 orientation 만 쓴다
+        fusionState[FUSION_RX] = ox;
+        fusionState[FUSION_RY] = oy;
+        fusionState[FUSION_RZ] = oz;
+        if (fusionOnUpdate) fusionOnUpdate();
+        return;
+    }
+    const w = FUSION_GYRO_WEIGHT;
+    fusionState[FUSION_RX] = w * fusionState[FUSION_RX] + (1 - w) * ox;
+    fusionState[FUSION_RY] = w * fusionState[FUSION_RY] + (1 - w) * oy;
+    fusionState[FUSION_RZ] = w * fusionState[FUSION_RZ] + (1 - w) * oz;
+}
+
+// 센서 구독 시작. 권한이 없거나 센서가 없으면 false.
+async function startSensorFusion(onUpdate) {
+    if (fusionListening) return true;
+    if (!(await requestMotionPermission())) return false;
+    fusionOnUpdate = onUpdate;
+    // 다시 구독할 때 멈춰 있던 시간을 한 번에 적분하지 않는다
+    fusionLastMotionT = 0;
+    window.addEventListener('devicemotion', onDeviceMotion, { passive: true });
+    window.addEventListener('deviceorientation', onDeviceOrientation, { passive: true });
+    fusionListening = true;
+    return true;
+}
+
+function stopSensorFusion() {
+    if (!fusionListening) return;
+    window.removeEventListener('devicemotion', onDeviceMotion);
+    window.removeEventListener('deviceorientation', onDeviceOrientation);
+    fusionListening = false;
+}
+
+// 현재 자세를 앵커로 삼는다
+function resetFusionAnchor() {
+    fusionState[FUSION_RX] = 0;
+    fusionState[FUSION_RY] = 0;
+    fusionState[FUSION_RZ] = 0;
+    fusionState[FUSION_HAS_REF] = 0;
+}
+
+// 앵커 이후 회전을 화면 이동/회전으로 바꿔 out 에 쓴다.
+//   out[0], out[1]: 장면 이동 (CSS px), out[2]: 화면 회전 (라디안, 시계 방향 +)
+//   viewLongSide: 화면에 보이는 비디오의 긴 변 (CSS px, cover 로 잘린 부분 포함)
+function readFusionOffset(viewLongSide, frontCamera, out) {
+    const focal = viewLongSide / (2 * Math.tan(CAMERA_LONG_FOV / 2));
+    // 세로 화면 기준: y 축 회전은 가로 이동, x 축 회전은 세로 이동, z 축 회전은 화면 회전
+    const dx = focal * fusionState[FUSION_RY];
+    let dy = -focal * fusionState[FUSION_RX];
+    let rot = fusionState[FUSION_RZ];
+    if (frontCamera) {
+        dy = -dy;
+        rot = -rot;
+    }
+    const angle = (screen.orientation ? screen.orientation.angle : (window.orientation || 0)) * DEG_TO_RAD;
+    const c = Math.cos(angle), s = Math.sin(angle);
+    out[0] = dx * c + dy * s;
+    out[1] = -dx * s + dy * c;
+    out[2] = rot;
+}
@@ -0,0 +1,58 @@
+// 배경 제거 모델/런타임 자산 캐시 서비스 워커
+// 라이브러리 JS, ONNX 모델 청크, onnxruntime Wasm 은 버전이 URL 에 들어가므로
+// Cache Storage 에 한 번 받아 두고 이후에는 네트워크 없이 응답한다.
+
+var CACHE_NAME = 'bg-removal-assets-v1';
+
+var CACHEABLE_PATTERNS = [
+    // 버전이 고정된 jsDelivr 패키지 (+esm 이 끌어오는 의존성 포함)
+    /^https:\/\/cdn\.jsdelivr\.net\/npm\/(@[^/]+\/)?[^/@]+@\d[^/]*\//,
+    // 실시간 컷아웃 MediaPipe 모델 (버전 디렉터리)
+    /^https:\/\/storage\.googleapis\.com\/mediapipe-models\/[^/]+\/[^/]+\/[^/]+\/\d+\//,
+    /^https:\/\/staticimgly\.com\/@imgly\/background-removal-data\/\d/,
+    // build.js 가 받아 둔 자체 호스팅 사본 (파일명 해시 / 버전 디렉터리)
+    new RegExp('^' + self.location.origin.replace(/[.*+?^${}()|[\]\\]/g, '\\$&') + '/vendor/imgly/(lib|data)/')
+];
+
+function isCacheable(url) {
+    for (var i = 0; i < CACHEABLE_PATTERNS.length; i++) {
+        if (CACHEABLE_PATTERNS[i].test(url)) return true;
+    }
+    return false;
+}
+
+self.addEventListener('install', function() {
+    self.skipWaiting();
+});
+
+self.addEventListener('activate', function(event) {
+    event.waitUntil((async function() {
+        var names = await caches.keys();
+        await Promise.all(names.filter(function(name) {
+            return name.indexOf('bg-removal-assets-') === 0 && name !== CACHE_NAME;
+        }).map(function(name) {
+            return caches.delete(name);
+        }));
+        await self.clients.claim();
+    })());
+});
+
+self.addEventListener('fetch', function(event) {
+    var request = event.request;
+    if (request.method !== 'GET' || !isCacheable(request.url)) return;
+
+    event.respondWith((async function() {
+        var cache = await caches.open(CACHE_NAME);
+        var cached = await cache.match(request.url);
+        if (cached) return cached;
+
+        var response = await fetch(request);
+        // opaque 응답은 크기/상태를 알 수 없고 COEP 와도 충돌하므로 저장하지 않는다
+        if (response.ok && response.type !== 'opaque') {
+            cache.put(request.url, response.clone()).catch(function(e) {
+                console.warn('[SW] 캐시 저장 실패:', request.url, e);
+            });
+        }
+        return response;
+    })());
+});
@@ -0,0 +1,186 @@
+// 업로드 후처리 워커
+//   choke:     배경 제거 결과 디코드 -> 타일 단위 알파 초크 -> 무손실 인코딩 (image-encoder.js)
+//   downscale: 빠른 모드용 입력 축소 (모델 해상도)
+//   refine:    저해상도 마스크를 원본 해상도로 업샘플링 -> 알파 초크 -> 무손실 인코딩
+//   hash:      입력 파일 SHA-256 (세그멘테이션 캐시 키)
+// 메인 스레드와는 Blob 만 주고받고 픽셀 배열은 이 워커 안에서만 다룬다.
+// 알파 초크는 겹치는 타일(경계 여유 = 초크 반경)로 나눠 돌리므로 ImageData / Wasm 힙은 타일 크기만큼만 쓴다.
+
+importScripts('wasm/loader.js', 'wasm/kernels.js', 'image-encoder.js');
+
+var kernelsReady = ImageKernels.load();
+
+// 저해상도 마스크 기준 가이드 필터 파라미터
+var GUIDED_RADIUS = 4;
+var GUIDED_EPS = 1e-3;
+
+// 초크 타일 한 변 (경계 여유 제외). 타일 하나의 작업 메모리는 (TILE_SIZE + 2r)^2 * 5 바이트 정도다.
+var CHOKE_TILE_SIZE = 1024;
+
+function postProgress(id, stage, ratio) {
+    self.postMessage({ type: 'progress', id: id, stage: stage, ratio: ratio });
+}
+
+function decodeToCanvas(bitmap) {
+    var canvas = new OffscreenCanvas(bitmap.width, bitmap.height);
+    var ctx = canvas.getContext('2d', { willReadFrequently: true });
+    ctx.drawImage(bitmap, 0, 0);
+    bitmap.close();
+    return { canvas: canvas, ctx: ctx };
+}
+
+// 침식 창이 타일 밖으로 나가지 않도록 사방에 radius 만큼 여유를 두고 읽고, 결과는 안쪽만 out 에 쓴다.
+// 이미지 가장자리에서는 여유가 잘리지만 커널이 이미지 밖을 불투명으로 보므로 통째로 처리한 것과 같다.
+// readTile(x, y, w, h): 원본(초크 전) 픽셀을 새 ImageData 로 돌려준다. out 은 같은 크기의 2D 컨텍스트.
+function chokeTiles(readTile, out, width, height, radius, onRow) {
+    var t0 = performance.now();
+    var path = null;
+    var tiles = 0;
+    for (var y = 0; y < height; y += CHOKE_TILE_SIZE) {
+        var ih = Math.min(CHOKE_TILE_SIZE, height - y);
+        var sy = Math.max(0, y - radius);
+        var sh = Math.min(height, y + ih + radius) - sy;
+        for (var x = 0; x < width; x += CHOKE_TILE_SIZE) {
+            var iw = Math.min(CHOKE_TILE_SIZE, width - x);
+            var sx = Math.max(0, x - radius);
+            var sw = Math.min(width, x + iw + radius) - sx;
+            var tile = readTile(sx, sy, sw, sh);
+            path = ImageKernels.chokeAlpha(tile.data, sw, sh, radius);
+            out.putImageData(tile, sx, sy, x - sx, y - sy, iw, ih);
+            tiles++;
+        }
+        if (onRow) onRow((y + ih) / height);
+    }
+    console.log('[Worker] 알파 초크 (' + path + '):', width + 'x' + height, tiles + '타일',
+        (performance.now() - t0).toFixed(1) + 'ms');
+}
+
+// 디코드된 비트맵에서 타일을 잘라 읽는 readTile
+function bitmapTileReader(bitmap) {
+    var canvas = new OffscreenCanvas(1, 1);
+    var ctx = canvas.getContext('2d', { willReadFrequently: true });
+    return function(sx, sy, sw, sh) {
+        if (canvas.width < sw || canvas.height < sh) {
+            canvas.width = Math.max(canvas.width, sw);
+            canvas.height = Math.max(canvas.height, sh);
+        }
+        ctx.clearRect(0, 0, sw, sh);
+        ctx.drawImage(bitmap, sx, sy, sw, sh, 0, 0, sw, sh);
+        return ctx.getImageData(0, 0, sw, sh);
+    };
+}
+
+// 이미 메모리에 있는 ImageData 에서 타일을 복사해 읽는 readTile
+function imageDataTileReader(imageData) {
+    var src = imageData.data;
+    var stride = imageData.width * 4;
+    return function(sx, sy, sw, sh) {
+        var tile = new ImageData(sw, sh);
+        var rowBytes = sw * 4;
+        for (var row = 0; row < sh; row++) {
+            var start = (sy + row) * stride + sx * 4;
+            tile.data.set(src.subarray(start, start + rowBytes), row * rowBytes);
+        }
+        return tile;
+    };
+}
+
+async function chokeCutout(id, blob, radius) {
+    postProgress(id, 'decode', 0);
+    var bitmap = await createImageBitmap(blob);
+    var w = bitmap.width;
+    var h = bitmap.height;
+    var canvas = new OffscreenCanvas(w, h);
+    var ctx = canvas.getContext('2d');
+
+    postProgress(id, 'choke', 0.3);
+    await kernelsReady;
+    try {
+        chokeTiles(bitmapTileReader(bitmap), ctx, w, h, radius, function(done) {
+            postProgress(id, 'choke', 0.3 + done * 0.3);
+        });
+    } finally {
+        bitmap.close();
+    }
+
+    postProgress(id, 'encode', 0.6);
+    return ImageEncoder.encodeCutout(canvas, ctx);
+}
+
+// 긴 변이 maxSide 이하가 되도록 줄인다. 이미 작으면 null 을 돌려준다.
+async function downscaleInput(id, blob, maxSide) {
+    var bitmap = await createImageBitmap(blob, { imageOrientation: 'from-image' });
+    var scale = maxSide / Math.max(bitmap.width, bitmap.height);
+    if (scale >= 1) {
+        bitmap.close();
+        return null;
+    }
+    var w = Math.round(bitmap.width * scale);
+    var h = Math.round(bitmap.height * scale);
+    var canvas = new OffscreenCanvas(w, h);
+    var ctx = canvas.getContext('2d');
+    ctx.imageSmoothingQuality = 'high';
+    ctx.drawImage(bitmap, 0, 0, w, h);
+    bitmap.close();
+    return canvas.convertToBlob({ type: 'image/png' });
+}
+
+async function refineCutout(id, original, maskBlob, radius) {
+    postProgress(id, 'decode', 0);
+    var target = decodeToCanvas(await createImageBitmap(original, { imageOrientation: 'from-image' }));
+    var mask = decodeToCanvas(await createImageBitmap(maskBlob));
+    var w = target.canvas.width;
+    var h = target.canvas.height;
+    var mw = mask.canvas.width;
+    var mh = mask.canvas.height;
+
+    postProgress(id, 'upsample', 0.2);
+    await kernelsReady;
+    var imageData = target.ctx.getImageData(0, 0, w, h);
+    var maskData = mask.ctx.getImageData(0, 0, mw, mh);
+    var t0 = performance.now();
+    var path = ImageKernels.upsampleMask(imageData.data, w, h, maskData.data, mw, mh, GUIDED_RADIUS, GUIDED_EPS);
+    console.log('[Worker] 마스크 업샘플링 (' + path + '):', mw + 'x' + mh, '->', w + 'x' + h,
+        (performance.now() - t0).toFixed(1) + 'ms');
+    maskData = null;
+
+    // 업샘플링 결과를 원본 삼아 초크하고 타일 안쪽만 대상 캔버스에 바로 쓴다
+    postProgress(id, 'choke', 0.4);
+    chokeTiles(imageDataTileReader(imageData), target.ctx, w, h, radius, function(done) {
+        postProgress(id, 'choke', 0.4 + done * 0.2);
+    });
+    imageData = null;
+
+    postProgress(id, 'encode', 0.6);
+    return ImageEncoder.encodeCutout(target.canvas, target.ctx);
+}
+
+async function hashBlob(blob) {
+    var digest = await crypto.subtle.digest('SHA-256', await blob.arrayBuffer());
+    var bytes = new Uint8Array(digest);
+    var hex = '';
+    for (var i = 0; i < bytes.length; i++) {
+        hex += (bytes[i] < 16 ? '0' : '') + bytes[i].toString(16);
+    }
+    return hex;
+}
+
+function runJob(msg) {
+    switch (msg.type) {
+        case 'choke': return chokeCutout(msg.id, msg.blob, msg.radius);
+        case 'downscale': return downscaleInput(msg.id, msg.blob, msg.maxSide);
+        case 'refine': return refineCutout(msg.id, msg.blob, msg.mask, msg.radius);
+        case 'hash': return hashBlob(msg.blob);
+        default: return Promise.reject(new Error('unknown_job: ' + msg.type));
+    }
+}
+
+self.onmessage = async function(e) {
+    var msg = e.data;
+    try {
+        var result = await runJob(msg);
+        self.postMessage({ type: 'done', id: msg.id, result: result });
+    } catch (err) {
+        self.postMessage({ type: 'error', id: msg.id, message: err && err.message ? err.message : String(err) });
+    }
+};
@@ -0,0 +1,206 @@
+// AR 화면 녹화
+// 카메라 프레임마다 호출 측이 합성 캔버스에 한 장을 그리면, WebCodecs 가 되면 VideoFrame 으로 record-worker.js 에
+// 넘겨 H.264(하드웨어 우선) + fMP4 로 인코딩하고, 안 되면 같은 캔버스의 captureStream() 을 MediaRecorder 로 녹화한다.
+// 결과는 bridge.js 의 저장 스트림으로 조각 단위로 흘려 보낸다.
+
+const RECORD_OPTIONS = {
+    longSide: 1280,          // 720p
+    fps: 30,
+    bitrate: 4000000,
+    keyIntervalSec: 2,
+    maxDurationMs: 60000,
+    // MediaRecorder 폴백의 dataavailable 간격
+    timesliceMs: 1000,
+};
+
+const RECORDER_MIME_TYPES = ['video/mp4;codecs=avc1', 'video/mp4', 'video/webm;codecs=vp9', 'video/webm;codecs=vp8', 'video/webm'];
+
+const recording = {
+    active: false,
+    mode: null,          // 'webcodecs' | 'mediarecorder'
+    canvas: null,
+    ctx: null,
+    draw: null,
+    worker: null,
+    recorder: null,
+    sink: null,
+    startedAt: 0,
+    lastFrameAt: 0,
+    frames: 0,
+    onLimit: null,
+    workerDone: null,
+};
+
+function isVideoRecording() {
+    return recording.active;
+}
+
+// 화면 비율을 유지하면서 긴 변을 longSide 로 맞춘 짝수 크기 (H.264 는 짝수 크기가 필요하다)
+function recordSize(viewWidth, viewHeight) {
+    const scale = RECORD_OPTIONS.longSide / Math.max(viewWidth, viewHeight);
+    return {
+        width: Math.round(viewWidth * scale / 2) * 2,
+        height: Math.round(viewHeight * scale / 2) * 2,
+    };
+}
+
+// 워커에 인코더를 맞춰 보고 H.264 를 쓸 수 없으면 null
+function startEncoderWorker(width, height) {
+    if (typeof VideoEncoder === 'undefined' || typeof VideoFrame === 'undefined' || typeof Worker === 'undefined') {
+        return Promise.resolve(null);
+    }
+    const worker = new Worker('record-worker.js');
+    return new Promise((resolve) => {
+        worker.onmessage = (e) => {
+            const msg = e.data;
+            if (msg.type === 'started') {
+                console.log('[AR] 녹화 인코더:', msg.codec, msg.hardwareAcceleration);
+                resolve(worker);
+            } else {
+                worker.terminate();
+                resolve(null);
+            }
+        };
+        worker.onerror = () => {
+            worker.terminate();
+            resolve(null);
+        };
+        worker.postMessage({
+            type: 'start', width, height,
+            fps: RECORD_OPTIONS.fps, bitrate: RECORD_OPTIONS.bitrate, keyIntervalSec: RECORD_OPTIONS.keyIntervalSec,
+        });
+    });
+}
+
+function attachEncoderWorker(worker) {
+    recording.workerDone = new Promise((resolve, reject) => {
+        worker.onmessage = (e) => {
+            const msg = e.data;
+            if (msg.type === 'data') recording.sink.write(msg.bytes);
+            else if (msg.type === 'done') resolve(msg);
+            else if (msg.type === 'error') {
+                console.error('[AR] 녹화 인코더 오류:', msg.message);
+                reject(new Error(msg.message));
+                if (recording.active && recording.onLimit) recording.onLimit();
+            }
+        };
+        worker.onerror = (e) => reject(new Error(e.message || 'worker_error'));
+    });
+    // 중간 오류는 stopVideoRecording 에서 알린다
+    recording.workerDone.catch(() => {});
+}
+
+function startMediaRecorder(canvas) {
+    if (typeof MediaRecorder === 'undefined' || !canvas.captureStream) throw new Error('녹화를 지원하지 않는 브라우저입니다');
+    const mimeType = RECORDER_MIME_TYPES.find((t) => MediaRecorder.isTypeSupported(t)) || '';
+    const recorder = new MediaRecorder(canvas.captureStream(RECORD_OPTIONS.fps), {
+        mimeType, videoBitsPerSecond: RECORD_OPTIONS.bitrate,
+    });
+    recorder.ondataavailable = (e) => {
+        if (e.data && e.data.size > 0) recording.sink.write(e.data);
+    };
+    recorder.start(RECORD_OPTIONS.timesliceMs);
+    console.log('[AR] 녹화 폴백: MediaRecorder', recorder.mimeType || mimeType);
+    return recorder;
+}
+
+// draw(ctx, width, height): 합성 캔버스에 현재 화면 한 장을 그린다
+// onLimit: 최대 길이에 닿거나 인코더가 멈췄을 때 (호출 측이 stopVideoRecording 을 부른다)
+async function startVideoRecording(viewWidth, viewHeight, draw, onLimit) {
+    if (recording.active) return recording.mode;
+    const size = recordSize(viewWidth, viewHeight);
+    const canvas = document.createElement('canvas');
+    canvas.width = size.width;
+    canvas.height = size.height;
+    recording.canvas = canvas;
+    recording.ctx = canvas.getContext('2d', { alpha: false });
+    recording.draw = draw;
+    recording.onLimit = onLimit;
+    recording.frames = 0;
+    recording.lastFrameAt = 0;
+    // captureStream 이 빈 캔버스로 시작하지 않도록 첫 장을 먼저 그린다
+    draw(recording.ctx, size.width, size.height);
+
+    const worker = await startEncoderWorker(size.width, size.height);
+    if (worker) {
+        recording.mode = 'webcodecs';
+        recording.worker = worker;
+        recording.sink = _openGallerySaveStream('video/mp4');
+        attachEncoderWorker(worker);
+    } else {
+        recording.mode = 'mediarecorder';
+        recording.recorder = startMediaRecorder(canvas);
+        recording.sink = _openGallerySaveStream(recording.recorder.mimeType.split(';')[0] || 'video/webm');
+    }
+    recording.startedAt = performance.now();
+    recording.active = true;
+    console.log('[AR] 녹화 시작:', recording.mode, size.width + 'x' + size.height);
+    return recording.mode;
+}
+
+// 카메라 프레임 콜백에서 부른다. 녹화 fps 보다 빠르게 오는 프레임은 건너뛴다.
+function recordVideoFrame() {
+    if (!recording.active) return;
+    const now = performance.now();
+    if (now - recording.lastFrameAt < 1000 / RECORD_OPTIONS.fps - 4) return;
+    if (now - recording.startedAt > RECORD_OPTIONS.maxDurationMs) {
+        if (recording.onLimit) recording.onLimit();
+        return;
+    }
+    recording.lastFrameAt = now;
+
+    const { canvas, ctx } = recording;
+    recording.draw(ctx, canvas.width, canvas.height);
+    if (recording.worker) {
+        const frame = new VideoFrame(canvas, { timestamp: Math.round((now - recording.startedAt) * 1000) });
+        recording.worker.postMessage({ type: 'frame', frame }, [frame]);
+    }
+    recording.frames++;
+    FrameStats.record('recordFrameMs', performance.now() - now);
+}
+
+// 녹화를 끝내고 남은 조각을 모두 저장할 때까지 기다린다.
+// 인코더가 중간에 실패해도 이미 쓴 조각은 저장을 마무리하고 summary.partial 로 알린다 (열린 네이티브 전송을 남기지 않는다).
+// 저장할 조각이 하나도 없으면 인코더 오류를 그대로 던진다.
+async function stopVideoRecording() {
+    if (!recording.active) return null;
+    recording.active = false;
+    const durationMs = performance.now() - recording.startedAt;
+    let dropped = 0;
+    let failure = null;
+    let written = 0;
+    try {
+        try {
+            if (recording.worker) {
+                recording.worker.postMessage({ type: 'stop' });
+                const result = await recording.workerDone;
+                dropped = result.dropped;
+            } else if (recording.recorder && recording.recorder.state !== 'inactive') {
+                await new Promise((resolve) => {
+                    recording.recorder.addEventListener('stop', resolve, { once: true });
+                    recording.recorder.stop();
+                });
+                recording.recorder.stream.getTracks().forEach((t) => t.stop());
+            }
+        } catch (e) {
+            failure = e;
+            console.error('[AR] 녹화 중단:', e.message);
+        }
+        written = recording.sink.bytesWritten();
+        if (written > 0) await recording.sink.close();
+        else recording.sink.abort();
+    } finally {
+        if (recording.worker) recording.worker.terminate();
+        recording.worker = null;
+        recording.recorder = null;
+        recording.sink = null;
+        recording.canvas = null;
+        recording.ctx = null;
+        recording.draw = null;
+    }
+    if (failure && written === 0) throw failure;
+    const summary = { mode: recording.mode, durationMs, frames: recording.frames, dropped, partial: failure !== null };
+    FrameStats.record('recordDuration', durationMs);
+    console.log('[AR] 녹화 종료:', summary);
+    return summary;
+}
@@ -0,0 +1,70 @@
+// 화면 <-> 카메라 비디오 좌표 변환 (cover 채우기 + 전면 카메라 좌우 반전)
+// 화면 크기, 비디오 해상도, 카메라 방향이 바뀔 때만 다시 계산하고
+// 미리보기(비디오 요소 배치), 캡처/녹화 합성, 시각 추적, 자이로가 모두 이 값을 같이 쓴다.
+
+const viewport = {
+    viewWidth: 0,       // 화면 (CSS px)
+    viewHeight: 0,
+    videoWidth: 0,      // 카메라 프레임 (px)
+    videoHeight: 0,
+    scale: 1,           // 비디오 1px 이 차지하는 CSS px
+    offX: 0,            // 비디오 원점의 화면 위치 (CSS px, cover 로 잘리면 음수)
+    offY: 0,
+    mirror: false,
+    // 화면에 보이는 비디오 영역 (비디오 px). 캡처 출력은 화면과 비율이 같으므로 크기와 상관없이 이 영역을 쓴다.
+    source: { sx: 0, sy: 0, sw: 0, sh: 0 },
+};
+
+// 바뀐 것이 없으면 false
+function updateViewport(videoWidth, videoHeight, viewWidth, viewHeight, mirror) {
+    const vp = viewport;
+    if (!videoWidth || !videoHeight) return false;
+    if (vp.videoWidth === videoWidth && vp.videoHeight === videoHeight &&
+        vp.viewWidth === viewWidth && vp.viewHeight === viewHeight && vp.mirror === mirror) return false;
+
+    vp.viewWidth = viewWidth;
+    vp.viewHeight = viewHeight;
+    vp.videoWidth = videoWidth;
+    vp.videoHeight = videoHeight;
+    vp.mirror = mirror;
+    vp.scale = Math.max(viewWidth / videoWidth, viewHeight / videoHeight);
+    vp.offX = (viewWidth - videoWidth * vp.scale) / 2;
+    vp.offY = (viewHeight - videoHeight * vp.scale) / 2;
+    vp.source.sx = -vp.offX / vp.scale;
+    vp.source.sy = -vp.offY / vp.scale;
+    vp.source.sw = viewWidth / vp.scale;
+    vp.source.sh = viewHeight / vp.scale;
+    return true;
+}
+
+// 비디오 요소를 viewport 값 그대로 배치한다 (object-fit 에 맡기지 않아 화면과 캡처가 같은 영역을 쓴다)
+function applyViewportToVideo(videoEl) {
+    const vp = viewport;
+    videoEl.style.objectFit = 'fill';
+    videoEl.style.left = vp.offX + 'px';
+    videoEl.style.top = vp.offY + 'px';
+    videoEl.style.width = vp.videoWidth * vp.scale + 'px';
+    videoEl.style.height = vp.videoHeight * vp.scale + 'px';
+}
+
+// 화면 점(CSS px) -> 비디오 좌표 (px). out 은 길이 2 이상 배열.
+function screenToVideo(x, y, out) {
+    const vp = viewport;
+    const sx = vp.mirror ? vp.viewWidth - x : x;
+    out[0] = (sx - vp.offX) / vp.scale;
+    out[1] = (y - vp.offY) / vp.scale;
+    return out;
+}
+
+// 비디오 좌표 (px) -> 화면 점 (CSS px)
+function videoToScreen(u, v, out) {
+    const sx = viewport.offX + u * viewport.scale;
+    out[0] = viewport.mirror ? viewport.viewWidth - sx : sx;
+    out[1] = viewport.offY + v * viewport.scale;
+    return out;
+}
+
+// 화면에 보이는 비디오(잘린 부분 포함)의 긴 변 (CSS px)
+function viewportVideoLongSide() {
+    return Math.max(viewport.videoWidth, viewport.videoHeight) * viewport.scale;
+}
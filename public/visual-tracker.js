@@ -0,0 +1,151 @@
+// 카메라 프레임 시각 추적 (wasm/visual-odometry, wasm/loader.js 필요)
+// 비디오를 작은 WebGL 캔버스에 축소해 그리고 readPixels 로 RGBA 를 Wasm 아레나에 바로 읽어 온 뒤 한 프레임씩 추적한다.
+// 프레임마다 새 버퍼를 만들지 않는다. WebGL 을 쓸 수 없으면 2D 캔버스 getImageData 로 복사한다.
+// 결과는 앵커 프레임 -> 현재 프레임 호모그래피 (축소 프레임 픽셀 좌표).
+
+// 축소 프레임 긴 변 (픽셀)
+const TRACKER_LONG_SIDE = 192;
+const TRACKER_MAX_FEATURES = 128;
+// 프레임당 추적 예산. 넘으면 다음 프레임 몇 개를 건너뛰어 카메라 30fps 를 지킨다.
+const TRACKER_BUDGET_MS = 8;
+
+// 축소 프레임 한 픽셀 안 네 점을 평균한다 (선형 필터만 쓰면 긴 변 1/10 축소에서 계단이 생긴다).
+// readPixels 는 아래 행부터 읽으므로 세로를 뒤집어 그려서 아레나에는 위 행부터 들어가게 한다.
+const TRACKER_DOWNSCALE_SHADER = `
+precision mediump float;
+varying vec2 v_uv;
+uniform sampler2D u_video;
+uniform vec2 u_step;
+void main() {
+    vec2 uv = vec2(v_uv.x, 1.0 - v_uv.y);
+    gl_FragColor = 0.25 * (
+        texture2D(u_video, uv + vec2(-u_step.x, -u_step.y)) +
+        texture2D(u_video, uv + vec2(u_step.x, -u_step.y)) +
+        texture2D(u_video, uv + vec2(-u_step.x, u_step.y)) +
+        texture2D(u_video, uv + vec2(u_step.x, u_step.y)));
+}`;
+
+const visualTracker = {
+    exports: null,
+    canvas: null,
+    ctx: null,          // 2D 폴백
+    gl: null,
+    program: null,
+    texture: null,
+    stepLocation: null,
+    width: 0,
+    height: 0,
+    videoWidth: 0,
+    videoHeight: 0,
+    buffer: null,
+    frameView: null,
+    homography: null,
+    skipFrames: 0,
+};
+
+async function initVisualTracker() {
+    if (typeof WasmLoader === 'undefined') return false;
+    const mod = await WasmLoader.load('visual-odometry');
+    if (!mod) return false;
+    const t = visualTracker;
+    t.exports = mod.exports;
+    try {
+        const { canvas, gl } = createHudGLCanvas(1, 1);
+        t.program = compileHudProgram(gl, TRACKER_DOWNSCALE_SHADER);
+        t.texture = createHudTexture(gl);
+        gl.useProgram(t.program);
+        gl.uniform1i(gl.getUniformLocation(t.program, 'u_video'), 0);
+        t.stepLocation = gl.getUniformLocation(t.program, 'u_step');
+        t.canvas = canvas;
+        t.gl = gl;
+    } catch (e) {
+        console.warn('[AR] 시각 추적 WebGL 축소 실패, 2D 캔버스로 전환:', e);
+        t.canvas = typeof OffscreenCanvas === 'function'
+            ? new OffscreenCanvas(1, 1)
+            : document.createElement('canvas');
+        t.ctx = t.canvas.getContext('2d', { willReadFrequently: true });
+    }
+    return true;
+}
+
+// 비디오 해상도가 바뀌면 (카메라 전환 등) 추적기를 다시 초기화한다
+function configureTracker(videoWidth, videoHeight) {
+    const t = visualTracker;
+    const scale = TRACKER_LONG_SIDE / Math.max(videoWidth, videoHeight);
+    t.width = Math.round(videoWidth * scale);
+    t.height = Math.round(videoHeight * scale);
+    t.canvas.width = t.width;
+    t.canvas.height = t.height;
+    const status = t.exports.vo_init(t.width, t.height, TRACKER_MAX_FEATURES);
+    if (status !== 0) throw new Error('vo_init 실패: ' + status);
+    t.videoWidth = videoWidth;
+    t.videoHeight = videoHeight;
+    t.buffer = null;
+    console.log('[AR] 시각 추적 해상도:', t.width, 'x', t.height);
+}
+
+// vo_init 이후에는 메모리가 늘지 않지만, 버퍼가 바뀌었으면 뷰를 다시 만든다
+function trackerViews() {
+    const t = visualTracker;
+    if (t.buffer !== t.exports.memory.buffer) {
+        t.buffer = t.exports.memory.buffer;
+        t.frameView = new Uint8Array(t.buffer, t.exports.vo_frame_buffer(), t.width * t.height * 4);
+        t.homography = new Float32Array(t.buffer, t.exports.vo_homography(), 9);
+    }
+}
+
+// 축소한 프레임을 아레나(frameView)에 직접 읽어 온다
+function readFrameGL(videoEl) {
+    const t = visualTracker;
+    const gl = t.gl;
+    gl.viewport(0, 0, t.width, t.height);
+    gl.useProgram(t.program);
+    gl.activeTexture(gl.TEXTURE0);
+    uploadVideoTexture(gl, t.texture, videoEl);
+    gl.uniform2f(t.stepLocation, 0.25 / t.width, 0.25 / t.height);
+    gl.drawArrays(gl.TRIANGLE_STRIP, 0, 4);
+    gl.readPixels(0, 0, t.width, t.height, gl.RGBA, gl.UNSIGNED_BYTE, t.frameView);
+}
+
+// 비디오 현재 프레임을 추적한다. 건너뛴 프레임이면 null.
+// 결과: { homography: Float32Array(9), confidence, width, height, reset }
+function trackVideoFrame(videoEl) {
+    const t = visualTracker;
+    if (!t.exports || !videoEl.videoWidth) return null;
+    if (t.skipFrames > 0) {
+        t.skipFrames--;
+        return null;
+    }
+
+    const t0 = performance.now();
+    let reset = false;
+    if (videoEl.videoWidth !== t.videoWidth || videoEl.videoHeight !== t.videoHeight) {
+        configureTracker(videoEl.videoWidth, videoEl.videoHeight);
+        reset = true;
+    }
+    trackerViews();
+
+    if (t.gl) {
+        readFrameGL(videoEl);
+    } else {
+        t.ctx.drawImage(videoEl, 0, 0, t.width, t.height);
+        t.frameView.set(t.ctx.getImageData(0, 0, t.width, t.height).data);
+    }
+    t.exports.vo_track_frame();
+
+    const elapsed = performance.now() - t0;
+    FrameStats.record('trackerMs', elapsed);
+    if (elapsed > TRACKER_BUDGET_MS) t.skipFrames = Math.min(3, Math.floor(elapsed / TRACKER_BUDGET_MS));
+
+    return {
+        homography: t.homography,
+        confidence: t.exports.vo_confidence(),
+        width: t.width,
+        height: t.height,
+        reset,
+    };
+}
+
+function resetTrackerAnchor() {
+    if (visualTracker.exports) visualTracker.exports.vo_reset_anchor();
+}
@@ -0,0 +1,173 @@
+// Wasm 이미지 커널 (메인 스레드 / 워커 공용, wasm/loader.js 필요)
+// src/cpp 의 알파 초크 / 마스크 업샘플링 커널을 감싸고, 불러오지 못하면 JS 경로로 처리한다.
+// 무손실 WebP 인코더는 JS 경로가 없어서 커널이 없으면 null 을 돌려준다.
+
+(function(global) {
+    var exports = null;
+    var variant = null;
+    var loading = null;
+
+    function load() {
+        if (loading) return loading;
+        loading = WasmLoader.load('image-kernels').then(function(mod) {
+            if (!mod) {
+                console.warn('[Wasm] 이미지 커널 로드 실패 — JS 경로 사용');
+                return false;
+            }
+            exports = mod.exports;
+            variant = mod.variant;
+            return true;
+        });
+        return loading;
+    }
+
+    // Wasm 커널을 쓸 수 없을 때의 3x3 최소 필터 (radius 회 반복)
+    function chokeAlphaJS(data, w, h, amount) {
+        var alphaOrig = new Uint8Array(w * h);
+        for (var i = 0; i < w * h; i++) {
+            alphaOrig[i] = data[i * 4 + 3];
+        }
+
+        for (var pass = 0; pass < amount; pass++) {
+            var alphaCopy = new Uint8Array(alphaOrig);
+            for (var y = 1; y < h - 1; y++) {
+                for (var x = 1; x < w - 1; x++) {
+                    var idx = y * w + x;
+                    var minAlpha = alphaCopy[idx];
+                    for (var dy = -1; dy <= 1; dy++) {
+                        for (var dx = -1; dx <= 1; dx++) {
+                            var nIdx = (y + dy) * w + (x + dx);
+                            minAlpha = Math.min(minAlpha, alphaCopy[nIdx]);
+                        }
+                    }
+                    alphaOrig[idx] = minAlpha;
+                }
+            }
+        }
+
+        for (var i = 0; i < w * h; i++) {
+            data[i * 4 + 3] = alphaOrig[i];
+        }
+    }
+
+    function chokeAlphaWasm(rgba, width, height, radius) {
+        if (!exports) return false;
+        var bytes = width * height * 4;
+        var ptr = exports.malloc(bytes);
+        if (!ptr) return false;
+        try {
+            // malloc 으로 메모리가 늘었을 수 있으니 뷰는 호출 직후에 만든다
+            new Uint8Array(exports.memory.buffer, ptr, bytes).set(rgba);
+            var status = exports.choke_alpha_rgba(ptr, width, height, radius);
+            if (status !== 0) {
+                console.warn('[Wasm] choke_alpha_rgba 실패:', status);
+                return false;
+            }
+            rgba.set(new Uint8Array(exports.memory.buffer, ptr, bytes));
+            return true;
+        } finally {
+            exports.free(ptr);
+        }
+    }
+
+    // RGBA 버퍼의 알파를 반경 radius 로 침식한다 (제자리).
+    // 사용한 경로('wasm' | 'js')를 반환한다.
+    function chokeAlpha(rgba, width, height, radius) {
+        if (chokeAlphaWasm(rgba, width, height, radius)) return 'wasm';
+        chokeAlphaJS(rgba, width, height, radius);
+        return 'js';
+    }
+
+    // 커널 없이 쓰는 쌍선형 업샘플링 (경계 보정 없음)
+    function upsampleMaskJS(guide, width, height, mask, maskWidth, maskHeight) {
+        var sx = maskWidth / width;
+        var sy = maskHeight / height;
+        for (var y = 0; y < height; y++) {
+            var fy = Math.max(0, (y + 0.5) * sy - 0.5);
+            var y0 = Math.min(fy | 0, maskHeight - 1);
+            var y1 = Math.min(y0 + 1, maskHeight - 1);
+            var ty = fy - y0;
+            for (var x = 0; x < width; x++) {
+                var fx = Math.max(0, (x + 0.5) * sx - 0.5);
+                var x0 = Math.min(fx | 0, maskWidth - 1);
+                var x1 = Math.min(x0 + 1, maskWidth - 1);
+                var tx = fx - x0;
+                var a00 = mask[(y0 * maskWidth + x0) * 4 + 3];
+                var a01 = mask[(y0 * maskWidth + x1) * 4 + 3];
+                var a10 = mask[(y1 * maskWidth + x0) * 4 + 3];
+                var a11 = mask[(y1 * maskWidth + x1) * 4 + 3];
+                var top = a00 + (a01 - a00) * tx;
+                var bottom = a10 + (a11 - a10) * tx;
+                guide[(y * width + x) * 4 + 3] = top + (bottom - top) * ty;
+            }
+        }
+    }
+
+    function upsampleMaskWasm(guide, width, height, mask, maskWidth, maskHeight, radius, eps) {
+        if (!exports) return false;
+        var guideBytes = width * height * 4;
+        var maskBytes = maskWidth * maskHeight * 4;
+        var guidePtr = exports.malloc(guideBytes);
+        var maskPtr = exports.malloc(maskBytes);
+        try {
+            if (!guidePtr || !maskPtr) return false;
+            var heap = new Uint8Array(exports.memory.buffer);
+            heap.set(guide, guidePtr);
+            heap.set(mask, maskPtr);
+            var status = exports.guided_upsample_alpha(guidePtr, width, height, maskPtr, maskWidth, maskHeight, radius, eps);
+            if (status !== 0) {
+                console.warn('[Wasm] guided_upsample_alpha 실패:', status);
+                return false;
+            }
+            guide.set(new Uint8Array(exports.memory.buffer, guidePtr, guideBytes));
+            return true;
+        } finally {
+            if (guidePtr) exports.free(guidePtr);
+            if (maskPtr) exports.free(maskPtr);
+        }
+    }
+
+    // 저해상도 마스크(mask 의 A 채널)를 원본 RGBA(guide)의 A 채널로 업샘플링한다.
+    // Wasm 에서는 가이드 필터로 경계를 원본에 맞추고, JS 폴백은 쌍선형 보간만 한다.
+    function upsampleMask(guide, width, height, mask, maskWidth, maskHeight, radius, eps) {
+        if (upsampleMaskWasm(guide, width, height, mask, maskWidth, maskHeight, radius, eps)) return 'wasm';
+        upsampleMaskJS(guide, width, height, mask, maskWidth, maskHeight);
+        return 'js';
+    }
+
+    // RGBA 버퍼를 무손실 WebP 파일 바이트(Uint8Array)로 만든다. 커널이 없거나 실패하면 null.
+    function encodeWebPLossless(rgba, width, height) {
+        if (!exports || !exports.webp_encode_lossless) return null;
+        var bytes = width * height * 4;
+        var inPtr = exports.malloc(bytes);
+        // [결과 포인터, 결과 크기]
+        var outPtr = exports.malloc(8);
+        try {
+            if (!inPtr || !outPtr) return null;
+            new Uint8Array(exports.memory.buffer, inPtr, bytes).set(rgba);
+            var status = exports.webp_encode_lossless(inPtr, width, height, outPtr, outPtr + 4);
+            if (status !== 0) {
+                console.warn('[Wasm] webp_encode_lossless 실패:', status);
+                return null;
+            }
+            var result = new Uint32Array(exports.memory.buffer, outPtr, 2);
+            var data = result[0];
+            var size = result[1];
+            var copy = new Uint8Array(exports.memory.buffer, data, size).slice();
+            exports.free(data);
+            return copy;
+        } finally {
+            if (inPtr) exports.free(inPtr);
+            if (outPtr) exports.free(outPtr);
+        }
+    }
+
+    global.ImageKernels = {
+        load: load,
+        isReady: function() { return exports !== null; },
+        variant: function() { return variant; },
+        chokeAlpha: chokeAlpha,
+        upsampleMask: upsampleMask,
+        encodeWebPLossless: encodeWebPLossless
+    };
+})(self);
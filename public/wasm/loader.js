@@ -0,0 +1,91 @@
+// Wasm 모듈 로더 (메인 스레드 / 워커 공용)
+// build-wasm.js 가 만든 <name>.wasm / .simd.wasm 중 이 기기에서 가장 빠른 변형을 불러온다.
+
+(function(global) {
+    // 워커에는 currentScript 가 없으므로 워커 스크립트(public/) 기준 wasm/ 폴더를 쓴다
+    var baseUrl = (typeof document !== 'undefined' && document.currentScript)
+        ? document.currentScript.src
+        : new URL('wasm/', global.location.href).href;
+
+    // wasm-feature-detect 의 SIMD128 검사 모듈
+    var SIMD_PROBE = new Uint8Array([
+        0, 97, 115, 109, 1, 0, 0, 0, 1, 5, 1, 96, 0, 1, 123, 3, 2, 1, 0,
+        10, 10, 1, 8, 0, 65, 0, 253, 15, 253, 98, 11
+    ]);
+
+    var modules = {};
+
+    function validates(probe) {
+        try {
+            return typeof WebAssembly === 'object' && WebAssembly.validate(probe);
+        } catch (e) {
+            return false;
+        }
+    }
+
+    // 지원하는 기능이 많은 변형부터 시도한다
+    function candidateVariants() {
+        var list = [];
+        if (validates(SIMD_PROBE)) list.push('simd');
+        list.push('baseline');
+        return list;
+    }
+
+    function variantUrl(name, variant) {
+        var suffix = variant === 'baseline' ? '' : '.' + variant;
+        return new URL(name + suffix + '.wasm', baseUrl).href;
+    }
+
+    // STANDALONE_WASM 빌드가 가져오는 WASI/env 함수는 커널에서 쓰지 않으므로 빈 함수로 채운다.
+    function stubImports() {
+        var stub = function() { return 0; };
+        var ns = new Proxy({}, { get: function() { return stub; } });
+        return new Proxy({}, { get: function() { return ns; } });
+    }
+
+    async function instantiate(url) {
+        var imports = stubImports();
+        if (WebAssembly.instantiateStreaming) {
+            try {
+                return await WebAssembly.instantiateStreaming(fetch(url), imports);
+            } catch (e) {
+                // application/wasm MIME 이 아닌 서버에서는 스트리밍 컴파일이 실패한다
+                console.warn('[Wasm] 스트리밍 컴파일 실패, 일반 로딩으로 재시도:', e.message);
+            }
+        }
+        var res = await fetch(url);
+        if (!res.ok) throw new Error('HTTP ' + res.status);
+        return WebAssembly.instantiate(await res.arrayBuffer(), imports);
+    }
+
+    // 모듈 이름별로 한 번만 불러온다. 실패하면 null 로 resolve 된다.
+    // 결과: { exports, variant } (exports.memory 는 항상 채워져 있다)
+    function load(name) {
+        if (modules[name]) return modules[name];
+        modules[name] = (async function() {
+            if (typeof WebAssembly !== 'object') {
+                console.log('[Wasm] WebAssembly 미지원:', name);
+                return null;
+            }
+            var candidates = candidateVariants();
+            for (var i = 0; i < candidates.length; i++) {
+                var variant = candidates[i];
+                try {
+                    var result = await instantiate(variantUrl(name, variant));
+                    var ex = result.instance.exports;
+                    if (ex._initialize) ex._initialize();
+                    console.log('[Wasm] ' + name + ' 로드 완료:', variant);
+                    return { exports: ex, variant: variant };
+                } catch (e) {
+                    console.warn('[Wasm] ' + name + ' ' + variant + ' 변형 로드 실패:', e.message);
+                }
+            }
+            return null;
+        })();
+        return modules[name];
+    }
+
+    global.WasmLoader = {
+        load: load
+    };
+})(self);
@@ -1,24 +1,123 @@
 const express = require('express');
+const fs = require('fs');
 const path = require('path');
 
 const app = express();
 const PORT = process.env.PORT || 3000;
+const PUBLIC_DIR = path.join(__dirname, 'public');
+
+// build.js 가 만든 압축본 (선호 순서)
+const PRECOMPRESSED = [
+    { encoding: 'br', ext: '.br' },
+    { encoding: 'gzip', ext: '.gz' },
+];
+
+// 스트리밍 컴파일(instantiateStreaming)은 application/wasm 이어야 동작한다
+const MIME_TYPES = {
+    '.wasm': 'application/wasm',
+    '.mjs': 'text/javascript; charset=utf-8',
+    '.js': 'text/javascript; charset=utf-8',
+    '.json': 'application/json; charset=utf-8',
+};
+
+// 파일명에 내용 해시가 들어간 자산은 내용이 바뀌면 URL 도 바뀐다
+const HASHED_ASSET = /(^|[/.])[0-9a-f]{16,}(\.[a-z0-9]+)?$/;
+
+function setCommonHeaders(res, filePath) {
+    // HTTPS 카메라 접근을 위한 헤더
+    res.setHeader('Permissions-Policy', 'camera=*, microphone=*');
+    // CORS 허용
+    res.setHeader('Access-Control-Allow-Origin', '*');
+    res.setHeader('Cache-Control', HASHED_ASSET.test(filePath)
+        ? 'public, max-age=31536000, immutable'
+        : 'no-cache');
+}
+
+function acceptedEncodings(header) {
+    const accepted = new Set();
+    for (const part of (header || '').split(',')) {
+        const [name, ...params] = part.trim().toLowerCase().split(';');
+        const q = params.find((p) => p.trim().startsWith('q='));
+        if (name && !(q && parseFloat(q.trim().slice(2)) === 0)) accepted.add(name);
+    }
+    return accepted;
+}
+
+// 교차 출처 격리 (COOP/COEP): SharedArrayBuffer 와 Wasm threads, 다중 스레드 onnxruntime 에 필요하다.
+// 외부 자산은 CORS 로 받는다 (jsDelivr 모듈, staticimgly 모델). build.js 로 vendoring 하면 모두 같은 출처다.
+// CROSS_ORIGIN_ISOLATION=0 이면 끈다.
+const CROSS_ORIGIN_ISOLATION = process.env.CROSS_ORIGIN_ISOLATION !== '0';
+
+app.use((req, res, next) => {
+    if (CROSS_ORIGIN_ISOLATION) {
+        res.setHeader('Cross-Origin-Opener-Policy', 'same-origin');
+        res.setHeader('Cross-Origin-Embedder-Policy', 'require-corp');
+    }
+    // CORS 를 모두 허용하므로 다른 격리 페이지에서도 자산을 쓸 수 있게 한다
+    res.setHeader('Cross-Origin-Resource-Policy', 'cross-origin');
+    next();
+});
+
+// 디렉터리 요청('/')도 index.html 압축본을 받도록 압축본 처리 전에 파일 경로로 바꾼다
+app.use((req, res, next) => {
+    if ((req.method === 'GET' || req.method === 'HEAD') && req.path.endsWith('/')) {
+        req.url = req.path + 'index.html' + req.url.slice(req.path.length);
+    }
+    next();
+});
+
+// 압축본이 있고 클라이언트가 받을 수 있으면 그것을 보낸다
+async function servePrecompressed(req, res, next) {
+    if (req.method !== 'GET' && req.method !== 'HEAD') return next();
+
+    let filePath;
+    try {
+        filePath = path.join(PUBLIC_DIR, decodeURIComponent(req.path));
+    } catch (e) {
+        return next();
+    }
+    if (!filePath.startsWith(PUBLIC_DIR + path.sep)) return next();
+
+    const accepted = acceptedEncodings(req.headers['accept-encoding']);
+    for (const { encoding, ext } of PRECOMPRESSED) {
+        if (!accepted.has(encoding)) continue;
+        try {
+            await fs.promises.access(filePath + ext);
+        } catch (e) {
+            continue;
+        }
+        setCommonHeaders(res, filePath);
+        res.setHeader('Content-Encoding', encoding);
+        res.setHeader('Vary', 'Accept-Encoding');
+        res.type(MIME_TYPES[path.extname(filePath)] || path.extname(filePath) || 'application/octet-stream');
+        return res.sendFile(filePath + ext, { dotfiles: 'deny' });
+    }
+    next();
+}
+
+app.use(servePrecompressed);
 
 // 정적 파일 서빙 (public 폴더)
-app.use(express.static(path.join(__dirname, 'public'), {
+app.use(express.static(PUBLIC_DIR, {
     setHeaders: (res, filePath) => {
-        // HTTPS 카메라 접근을 위한 헤더
-        res.setHeader('Permissions-Policy', 'camera=*, microphone=*');
-        // CORS 허용
-        res.setHeader('Access-Control-Allow-Origin', '*');
+        setCommonHeaders(res, filePath);
+        const mime = MIME_TYPES[path.extname(filePath)];
+        if (mime) res.setHeader('Content-Type', mime);
+        // 같은 파일의 압축본이 있으면 캐시가 인코딩별로 구분되어야 한다
+        res.setHeader('Vary', 'Accept-Encoding');
     }
 }));
 
-// SPA 폴백
+// SPA 폴백 (index.html 도 압축본을 먼저 찾는다)
 app.get('{*path}', (req, res) => {
-    res.sendFile(path.join(__dirname, 'public', 'index.html'));
+    req.url = '/index.html';
+    servePrecompressed(req, res, () => {
+        setCommonHeaders(res, 'index.html');
+        res.sendFile(path.join(PUBLIC_DIR, 'index.html'));
+    });
 });
 
 app.listen(PORT, () => {
-    console.log(`AR Vision server running on port ${PORT}`);
+    console.log(`AR Vision server running on port ${PORT}` +
+        (CROSS_ORIGIN_ISOLATION ? ' (cross-origin isolated)' : ''));
 });
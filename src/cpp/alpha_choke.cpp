@@ -0,0 +1,182 @@
+// 알파 초크(침식) 커널
+//
+// 배경 제거 결과의 알파 채널을 (2r+1)x(2r+1) 정사각 최소 필터로 깎아낸다.
+// van Herk/Gil-Werman 분리형 필터를 써서 반경과 무관하게 픽셀당 비교 3회로 끝난다.
+// 가로 패스는 행 단위 스칼라, 세로 패스는 16열씩 묶어 SIMD128 로 처리한다.
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+
+#ifdef __wasm_simd128__
+#include <wasm_simd128.h>
+#endif
+
+#include "wasm_common.h"
+
+namespace {
+
+constexpr int kStripWidth = 16;
+
+// 1개 바이트 단위 레인 (가로 패스)
+struct ScalarLane {
+    using T = uint8_t;
+    static T load(const uint8_t* p) { return *p; }
+    static void store(uint8_t* p, T v) { *p = v; }
+    static T min(T a, T b) { return a < b ? a : b; }
+    static T opaque() { return 255; }
+};
+
+#ifdef __wasm_simd128__
+// 16열 묶음 레인 (세로 패스, SIMD128)
+struct StripLane {
+    using T = v128_t;
+    static T load(const uint8_t* p) { return wasm_v128_load(p); }
+    static void store(uint8_t* p, T v) { wasm_v128_store(p, v); }
+    static T min(T a, T b) { return wasm_u8x16_min(a, b); }
+    static T opaque() { return wasm_u8x16_splat(255); }
+};
+#else
+// 16열 묶음 레인 (세로 패스, SIMD 미지원 빌드) — 연속 메모리라 자동 벡터화된다
+struct StripLane {
+    struct T {
+        uint8_t v[kStripWidth];
+    };
+    static T load(const uint8_t* p) {
+        T r;
+        std::memcpy(r.v, p, kStripWidth);
+        return r;
+    }
+    static void store(uint8_t* p, const T& v) { std::memcpy(p, v.v, kStripWidth); }
+    static T min(const T& a, const T& b) {
+        T r;
+        for (int i = 0; i < kStripWidth; ++i) r.v[i] = a.v[i] < b.v[i] ? a.v[i] : b.v[i];
+        return r;
+    }
+    static T opaque() {
+        T r;
+        std::memset(r.v, 255, kStripWidth);
+        return r;
+    }
+};
+#endif
+
+// 앞뒤로 r 만큼 패딩한 길이를 블록 크기(2r+1)의 배수로 올린다
+inline int paddedLength(int n, int r) {
+    const int k = 2 * r + 1;
+    return ((n + 2 * r + k - 1) / k) * k;
+}
+
+// 1차원 vHGW 최소 필터 (제자리 갱신)
+// data 에서 stride 간격으로 n 개를 읽어 반경 r 로 침식한다.
+// 이미지 밖은 255(불투명)로 보므로 가장자리가 추가로 깎이지 않는다.
+// g, h 는 paddedLength(n, r) 개짜리 작업 버퍼.
+template <class Lane>
+void minFilter1D(uint8_t* data, ptrdiff_t stride, int n, int r,
+                 typename Lane::T* g, typename Lane::T* h) {
+    const int k = 2 * r + 1;
+    const int len = paddedLength(n, r);
+
+    for (int i = 0; i < len; ++i) {
+        const int src = i - r;
+        g[i] = (src >= 0 && src < n) ? Lane::load(data + src * stride) : Lane::opaque();
+        h[i] = g[i];
+    }
+
+    // 블록 내 누적 최소값: g 는 앞에서부터, h 는 뒤에서부터
+    for (int b = 0; b < len; b += k) {
+        for (int i = b + 1; i < b + k; ++i) g[i] = Lane::min(g[i - 1], g[i]);
+        for (int i = b + k - 2; i >= b; --i) h[i] = Lane::min(h[i + 1], h[i]);
+    }
+
+    // 패딩 좌표에서 창 [x, x + 2r] 의 최소값 = min(h[x], g[x + 2r])
+    for (int x = 0; x < n; ++x) {
+        Lane::store(data + x * stride, Lane::min(h[x], g[x + k - 1]));
+    }
+}
+
+void extractAlpha(const uint8_t* rgba, uint8_t* alpha, size_t count) {
+    size_t i = 0;
+#ifdef __wasm_simd128__
+    for (; i + 16 <= count; i += 16) {
+        const uint8_t* p = rgba + i * 4;
+        v128_t v0 = wasm_v128_load(p);
+        v128_t v1 = wasm_v128_load(p + 16);
+        v128_t v2 = wasm_v128_load(p + 32);
+        v128_t v3 = wasm_v128_load(p + 48);
+        v128_t lo = wasm_i8x16_shuffle(v0, v1, 3, 7, 11, 15, 19, 23, 27, 31, 3, 7, 11, 15, 19, 23, 27, 31);
+        v128_t hi = wasm_i8x16_shuffle(v2, v3, 3, 7, 11, 15, 19, 23, 27, 31, 3, 7, 11, 15, 19, 23, 27, 31);
+        wasm_v128_store(alpha + i, wasm_i8x16_shuffle(lo, hi, 0, 1, 2, 3, 4, 5, 6, 7, 16, 17, 18, 19, 20, 21, 22, 23));
+    }
+#endif
+    for (; i < count; ++i) alpha[i] = rgba[i * 4 + 3];
+}
+
+void insertAlpha(uint8_t* rgba, const uint8_t* alpha, size_t count) {
+    size_t i = 0;
+#ifdef __wasm_simd128__
+    for (; i + 16 <= count; i += 16) {
+        uint8_t* p = rgba + i * 4;
+        v128_t a = wasm_v128_load(alpha + i);
+        wasm_v128_store(p, wasm_i8x16_shuffle(wasm_v128_load(p), a, 0, 1, 2, 16, 4, 5, 6, 17, 8, 9, 10, 18, 12, 13, 14, 19));
+        wasm_v128_store(p + 16, wasm_i8x16_shuffle(wasm_v128_load(p + 16), a, 0, 1, 2, 20, 4, 5, 6, 21, 8, 9, 10, 22, 12, 13, 14, 23));
+        wasm_v128_store(p + 32, wasm_i8x16_shuffle(wasm_v128_load(p + 32), a, 0, 1, 2, 24, 4, 5, 6, 25, 8, 9, 10, 26, 12, 13, 14, 27));
+        wasm_v128_store(p + 48, wasm_i8x16_shuffle(wasm_v128_load(p + 48), a, 0, 1, 2, 28, 4, 5, 6, 29, 8, 9, 10, 30, 12, 13, 14, 31));
+    }
+#endif
+    for (; i < count; ++i) rgba[i * 4 + 3] = alpha[i];
+}
+
+// 알파 평면을 제자리에서 (2r+1)x(2r+1) 침식한다
+int erodePlane(uint8_t* plane, int width, int height, int r) {
+    const int lenH = paddedLength(width, r);
+    const int lenV = paddedLength(height, r);
+    const size_t scratchBytes = sizeof(StripLane::T) * static_cast<size_t>(lenV) * 2 +
+                                static_cast<size_t>(lenH) * 2;
+    uint8_t* scratch = static_cast<uint8_t*>(std::malloc(scratchBytes));
+    if (!scratch) return KERNEL_OUT_OF_MEMORY;
+
+    auto* gv = reinterpret_cast<StripLane::T*>(scratch);
+    auto* hv = gv + lenV;
+    uint8_t* gh = reinterpret_cast<uint8_t*>(hv + lenV);
+    uint8_t* hh = gh + lenH;
+
+    for (int y = 0; y < height; ++y) {
+        minFilter1D<ScalarLane>(plane + static_cast<size_t>(y) * width, 1, width, r, gh, hh);
+    }
+
+    int x = 0;
+    for (; x + kStripWidth <= width; x += kStripWidth) {
+        minFilter1D<StripLane>(plane + x, width, height, r, gv, hv);
+    }
+    // 16열이 안 되는 오른쪽 끝은 열 단위로 처리
+    uint8_t* gs = reinterpret_cast<uint8_t*>(gv);
+    uint8_t* hs = gs + lenV;
+    for (; x < width; ++x) {
+        minFilter1D<ScalarLane>(plane + x, width, height, r, gs, hs);
+    }
+
+    std::free(scratch);
+    return KERNEL_OK;
+}
+
+}  // namespace
+
+// RGBA 버퍼(getImageData 결과와 같은 배치)의 알파 채널을 반경 radius 로 침식한다.
+// radius 1 은 기존 JS 구현의 3x3 1회 패스와 같다.
+WASM_EXPORT int choke_alpha_rgba(uint8_t* rgba, int width, int height, int radius) {
+    if (!rgba || width <= 0 || height <= 0 || radius < 0) return KERNEL_INVALID_ARGS;
+    if (radius == 0) return KERNEL_OK;
+
+    const size_t count = static_cast<size_t>(width) * height;
+    uint8_t* plane = static_cast<uint8_t*>(std::malloc(count));
+    if (!plane) return KERNEL_OUT_OF_MEMORY;
+
+    extractAlpha(rgba, plane, count);
+    const int status = erodePlane(plane, width, height, radius);
+    if (status == KERNEL_OK) insertAlpha(rgba, plane, count);
+
+    std::free(plane);
+    return status;
+}
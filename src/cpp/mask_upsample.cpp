@@ -0,0 +1,188 @@
+// 저해상도 마스크 -> 원본 해상도 업샘플링 (Fast Guided Filter)
+//
+// 축소된 이미지로 얻은 세그멘테이션 마스크를 원본 밝기 영상을 가이드 삼아 키운다.
+// 가이드 필터 계수 a, b 는 저해상도에서만 계산하고, 원본 해상도에서는
+// a, b 를 쌍선형 보간해 q = a * I + b 만 구하므로 비용이 픽셀 수에 선형이다.
+// (He & Sun, "Fast Guided Filter", 2015)
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+
+#include "wasm_common.h"
+
+namespace {
+
+inline int clampi(int v, int lo, int hi) { return v < lo ? lo : (v > hi ? hi : v); }
+
+inline uint8_t luma(const uint8_t* px) {
+    return static_cast<uint8_t>((77 * px[0] + 150 * px[1] + 29 * px[2]) >> 8);
+}
+
+// 반경 r 박스 평균 (경계는 창 안에 들어온 픽셀 수로 정규화). colSum 은 w 개 작업 버퍼.
+void boxMean(const float* src, float* dst, int w, int h, int r, float* colSum) {
+    std::memset(colSum, 0, sizeof(float) * w);
+    for (int y = 0; y < r && y < h; ++y) {
+        const float* row = src + static_cast<size_t>(y) * w;
+        for (int x = 0; x < w; ++x) colSum[x] += row[x];
+    }
+
+    for (int y = 0; y < h; ++y) {
+        const int addY = y + r;
+        const int subY = y - r - 1;
+        if (addY < h) {
+            const float* row = src + static_cast<size_t>(addY) * w;
+            for (int x = 0; x < w; ++x) colSum[x] += row[x];
+        }
+        if (subY >= 0) {
+            const float* row = src + static_cast<size_t>(subY) * w;
+            for (int x = 0; x < w; ++x) colSum[x] -= row[x];
+        }
+        const int rows = (addY < h ? addY : h - 1) - (subY >= 0 ? subY : -1);
+
+        float* out = dst + static_cast<size_t>(y) * w;
+        float acc = 0.0f;
+        for (int x = 0; x < r && x < w; ++x) acc += colSum[x];
+        for (int x = 0; x < w; ++x) {
+            const int addX = x + r;
+            const int subX = x - r - 1;
+            if (addX < w) acc += colSum[addX];
+            if (subX >= 0) acc -= colSum[subX];
+            const int cols = (addX < w ? addX : w - 1) - (subX >= 0 ? subX : -1);
+            out[x] = acc / static_cast<float>(rows * cols);
+        }
+    }
+}
+
+// 원본 RGBA 를 저해상도 격자에 면적 평균해 [0,1] 밝기로 만든다
+void downsampleLuma(const uint8_t* rgba, int w, int h, float* out, int mw, int mh,
+                    int* xMap, float* count) {
+    const size_t lowCount = static_cast<size_t>(mw) * mh;
+    std::memset(out, 0, sizeof(float) * lowCount);
+    std::memset(count, 0, sizeof(float) * lowCount);
+    for (int x = 0; x < w; ++x) xMap[x] = static_cast<int>(static_cast<int64_t>(x) * mw / w);
+
+    for (int y = 0; y < h; ++y) {
+        const int ly = static_cast<int>(static_cast<int64_t>(y) * mh / h);
+        const uint8_t* row = rgba + static_cast<size_t>(y) * w * 4;
+        float* dst = out + static_cast<size_t>(ly) * mw;
+        float* cnt = count + static_cast<size_t>(ly) * mw;
+        for (int x = 0; x < w; ++x) {
+            dst[xMap[x]] += luma(row + x * 4);
+            cnt[xMap[x]] += 1.0f;
+        }
+    }
+    for (size_t i = 0; i < lowCount; ++i) {
+        out[i] = count[i] > 0 ? out[i] / (count[i] * 255.0f) : 0.0f;
+    }
+}
+
+}  // namespace
+
+// guide: 원본 해상도 RGBA (width x height). 결과 알파를 이 버퍼의 A 채널에 쓴다.
+// mask: 저해상도 RGBA (maskWidth x maskHeight), A 채널이 세그멘테이션 결과.
+// radius/eps: 저해상도 기준 가이드 필터 반경과 정규화 항.
+WASM_EXPORT int guided_upsample_alpha(uint8_t* guide, int width, int height,
+                                      const uint8_t* mask, int maskWidth, int maskHeight,
+                                      int radius, float eps) {
+    if (!guide || !mask || width <= 0 || height <= 0 || maskWidth <= 0 || maskHeight <= 0 ||
+        radius < 1 || !(eps > 0.0f)) {
+        return KERNEL_INVALID_ARGS;
+    }
+
+    const int mw = maskWidth;
+    const int mh = maskHeight;
+    const size_t lowCount = static_cast<size_t>(mw) * mh;
+
+    // 저해상도 평면 7장 + 행 버퍼
+    const size_t planeFloats = lowCount * 7;
+    const size_t rowFloats = static_cast<size_t>(mw) * 3 + width;
+    float* arena = static_cast<float*>(std::malloc(sizeof(float) * (planeFloats + rowFloats)));
+    int* xMap = static_cast<int*>(std::malloc(sizeof(int) * width * 2));
+    if (!arena || !xMap) {
+        std::free(arena);
+        std::free(xMap);
+        return KERNEL_OUT_OF_MEMORY;
+    }
+
+    float* I = arena;
+    float* p = I + lowCount;
+    float* meanI = p + lowCount;
+    float* meanP = meanI + lowCount;
+    float* corrI = meanP + lowCount;
+    float* corrIp = corrI + lowCount;
+    float* tmp = corrIp + lowCount;
+    float* colSum = tmp + lowCount;
+    float* rowA = colSum + mw;
+    float* rowB = rowA + mw;
+    float* fx = rowB + mw;
+
+    downsampleLuma(guide, width, height, I, mw, mh, xMap, tmp);
+    for (size_t i = 0; i < lowCount; ++i) p[i] = mask[i * 4 + 3] * (1.0f / 255.0f);
+
+    boxMean(I, meanI, mw, mh, radius, colSum);
+    boxMean(p, meanP, mw, mh, radius, colSum);
+    for (size_t i = 0; i < lowCount; ++i) tmp[i] = I[i] * I[i];
+    boxMean(tmp, corrI, mw, mh, radius, colSum);
+    for (size_t i = 0; i < lowCount; ++i) tmp[i] = I[i] * p[i];
+    boxMean(tmp, corrIp, mw, mh, radius, colSum);
+
+    // a, b 를 I, p 자리에 덮어쓰고 다시 평균낸다
+    for (size_t i = 0; i < lowCount; ++i) {
+        const float varI = corrI[i] - meanI[i] * meanI[i];
+        const float cov = corrIp[i] - meanI[i] * meanP[i];
+        const float a = cov / (varI + eps);
+        I[i] = a;
+        p[i] = meanP[i] - a * meanI[i];
+    }
+    float* meanA = meanI;
+    float* meanB = meanP;
+    boxMean(I, meanA, mw, mh, radius, colSum);
+    boxMean(p, meanB, mw, mh, radius, colSum);
+
+    // 원본 해상도로 a, b 쌍선형 보간 (픽셀 중심 정렬)
+    int* x0 = xMap;
+    int* x1 = xMap + width;
+    const float sx = static_cast<float>(mw) / width;
+    const float sy = static_cast<float>(mh) / height;
+    for (int x = 0; x < width; ++x) {
+        float src = (x + 0.5f) * sx - 0.5f;
+        if (src < 0) src = 0;
+        const int i0 = clampi(static_cast<int>(src), 0, mw - 1);
+        x0[x] = i0;
+        x1[x] = clampi(i0 + 1, 0, mw - 1);
+        fx[x] = src - i0;
+    }
+
+    for (int y = 0; y < height; ++y) {
+        float srcY = (y + 0.5f) * sy - 0.5f;
+        if (srcY < 0) srcY = 0;
+        const int y0 = clampi(static_cast<int>(srcY), 0, mh - 1);
+        const int y1 = clampi(y0 + 1, 0, mh - 1);
+        const float fy = srcY - y0;
+
+        const float* a0 = meanA + static_cast<size_t>(y0) * mw;
+        const float* a1 = meanA + static_cast<size_t>(y1) * mw;
+        const float* b0 = meanB + static_cast<size_t>(y0) * mw;
+        const float* b1 = meanB + static_cast<size_t>(y1) * mw;
+        for (int x = 0; x < mw; ++x) {
+            rowA[x] = a0[x] + (a1[x] - a0[x]) * fy;
+            rowB[x] = b0[x] + (b1[x] - b0[x]) * fy;
+        }
+
+        uint8_t* px = guide + static_cast<size_t>(y) * width * 4;
+        for (int x = 0; x < width; ++x, px += 4) {
+            const float t = fx[x];
+            const float a = rowA[x0[x]] + (rowA[x1[x]] - rowA[x0[x]]) * t;
+            const float b = rowB[x0[x]] + (rowB[x1[x]] - rowB[x0[x]]) * t;
+            float q = a * (luma(px) * (1.0f / 255.0f)) + b;
+            q = q < 0.0f ? 0.0f : (q > 1.0f ? 1.0f : q);
+            px[3] = static_cast<uint8_t>(q * 255.0f + 0.5f);
+        }
+    }
+
+    std::free(xMap);
+    std::free(arena);
+    return KERNEL_OK;
+}
@@ -0,0 +1,583 @@
+// Visual Odometry: FAST 코너 + 피라미드 Lucas-Kanade 옵티컬 플로 + RANSAC 호모그래피
+//
+// 축소한 카메라 프레임(RGBA)을 받아 이전 프레임 대비 특징점 이동을 추적하고,
+// 기준(앵커) 프레임 -> 현재 프레임 호모그래피를 누적한다. 평면에 가까운 장면에서는
+// 이 호모그래피로 화면 위 HUD 를 장면에 고정할 수 있다.
+//
+// 메모리는 vo_init 에서 아레나 하나로 잡고, 프레임마다 피라미드 두 벌을 번갈아 덮어쓴다.
+// 프레임 처리 중에는 할당하지 않는다.
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+
+#ifdef __wasm_simd128__
+#include <wasm_simd128.h>
+#endif
+
+#include "wasm_common.h"
+
+namespace {
+
+constexpr int kLevels = 3;             // 피라미드 단계 (1, 1/2, 1/4)
+constexpr int kHalfWindow = 4;         // LK 창 9x9
+constexpr int kWindowSize = 2 * kHalfWindow + 1;
+constexpr int kWindowArea = kWindowSize * kWindowSize;
+constexpr int kMaxIterations = 8;
+constexpr float kMinEigen = 1e-3f;     // 창 기울기 행렬 최소 고유값 (정규화된 값 기준)
+constexpr int kFastThreshold = 20;
+constexpr int kBorder = kHalfWindow + 4;
+constexpr int kRansacIterations = 64;
+constexpr float kRansacThreshold = 2.0f;  // 재투영 오차 (레벨 0 픽셀)
+constexpr int kMinInliers = 8;
+
+struct Level {
+    uint8_t* data;
+    int width;
+    int height;
+};
+
+struct Pyramid {
+    Level levels[kLevels];
+};
+
+struct Point {
+    float x;
+    float y;
+};
+
+struct Tracker {
+    void* arena;
+    int width;
+    int height;
+    int maxFeatures;
+
+    uint8_t* frame;        // 입력 RGBA (width * height * 4)
+    Pyramid pyramids[2];
+    int current;           // pyramids[current] 가 이번 프레임
+    bool hasPrevious;
+
+    Point* prevPoints;
+    Point* nextPoints;
+    Point* srcInliers;
+    Point* dstInliers;
+    int count;
+
+    // 특징점 격자 (칸마다 최고 점수 코너 하나)
+    int gridCols;
+    int gridRows;
+    int cellSize;
+    int* cellScore;
+    Point* cellPoint;
+
+    float homography[9];   // 앵커 -> 현재 프레임 (행 우선)
+    float confidence;
+    uint32_t rng;
+};
+
+Tracker g = {};
+
+inline size_t alignUp(size_t n) { return (n + 15) & ~static_cast<size_t>(15); }
+
+void setIdentity(float* h) {
+    std::memset(h, 0, sizeof(float) * 9);
+    h[0] = h[4] = h[8] = 1.0f;
+}
+
+// === 피라미드 ===
+
+void rgbaToGray(const uint8_t* rgba, uint8_t* gray, int n) {
+    int i = 0;
+#ifdef __wasm_simd128__
+    // 4픽셀씩: R*77 + G*150 + B*29 >> 8
+    const v128_t mask = wasm_i32x4_splat(0xff);
+    const v128_t wr = wasm_i32x4_splat(77);
+    const v128_t wg = wasm_i32x4_splat(150);
+    const v128_t wb = wasm_i32x4_splat(29);
+    for (; i + 4 <= n; i += 4) {
+        const v128_t px = wasm_v128_load(rgba + i * 4);
+        const v128_t r = wasm_v128_and(px, mask);
+        const v128_t gch = wasm_v128_and(wasm_u32x4_shr(px, 8), mask);
+        const v128_t b = wasm_v128_and(wasm_u32x4_shr(px, 16), mask);
+        v128_t y = wasm_i32x4_add(wasm_i32x4_mul(r, wr), wasm_i32x4_mul(gch, wg));
+        y = wasm_u32x4_shr(wasm_i32x4_add(y, wasm_i32x4_mul(b, wb)), 8);
+        gray[i] = static_cast<uint8_t>(wasm_i32x4_extract_lane(y, 0));
+        gray[i + 1] = static_cast<uint8_t>(wasm_i32x4_extract_lane(y, 1));
+        gray[i + 2] = static_cast<uint8_t>(wasm_i32x4_extract_lane(y, 2));
+        gray[i + 3] = static_cast<uint8_t>(wasm_i32x4_extract_lane(y, 3));
+    }
+#endif
+    for (; i < n; ++i) {
+        const uint8_t* px = rgba + i * 4;
+        gray[i] = static_cast<uint8_t>((77 * px[0] + 150 * px[1] + 29 * px[2]) >> 8);
+    }
+}
+
+// 2x2 평균으로 한 단계 축소
+void halve(const Level& src, const Level& dst) {
+    for (int y = 0; y < dst.height; ++y) {
+        const uint8_t* r0 = src.data + static_cast<size_t>(2 * y) * src.width;
+        const uint8_t* r1 = r0 + src.width;
+        uint8_t* out = dst.data + static_cast<size_t>(y) * dst.width;
+        for (int x = 0; x < dst.width; ++x) {
+            out[x] = static_cast<uint8_t>((r0[2 * x] + r0[2 * x + 1] + r1[2 * x] + r1[2 * x + 1] + 2) >> 2);
+        }
+    }
+}
+
+void buildPyramid(Pyramid& pyr, const uint8_t* rgba) {
+    rgbaToGray(rgba, pyr.levels[0].data, pyr.levels[0].width * pyr.levels[0].height);
+    for (int l = 1; l < kLevels; ++l) halve(pyr.levels[l - 1], pyr.levels[l]);
+}
+
+// === FAST-9 ===
+
+// 반지름 3 Bresenham 원 (시계 방향 16점)
+const int kCircleX[16] = {0, 1, 2, 3, 3, 3, 2, 1, 0, -1, -2, -3, -3, -3, -2, -1};
+const int kCircleY[16] = {-3, -3, -2, -1, 0, 1, 2, 3, 3, 3, 2, 1, 0, -1, -2, -3};
+
+// 연속 9점 이상이 중심보다 모두 밝거나 모두 어두우면 코너. 점수는 해당 호의 차이 합.
+int fastScore(const Level& lv, int x, int y, const int* offsets) {
+    const uint8_t* p = lv.data + static_cast<size_t>(y) * lv.width + x;
+    const int c = p[0];
+    const int hi = c + kFastThreshold;
+    const int lo = c - kFastThreshold;
+
+    // 빠른 기각: 9점 호는 4개의 방위점 중 최소 2개를 포함한다
+    int brightCompass = 0, darkCompass = 0;
+    for (int k = 0; k < 16; k += 4) {
+        const int v = p[offsets[k]];
+        brightCompass += v > hi;
+        darkCompass += v < lo;
+    }
+    if (brightCompass < 2 && darkCompass < 2) return 0;
+
+    uint32_t bright = 0, dark = 0;
+    int brightSum = 0, darkSum = 0;
+    for (int k = 0; k < 16; ++k) {
+        const int v = p[offsets[k]];
+        if (v > hi) {
+            bright |= 1u << k;
+            brightSum += v - hi;
+        } else if (v < lo) {
+            dark |= 1u << k;
+            darkSum += lo - v;
+        }
+    }
+    auto hasArc = [](uint32_t m) {
+        uint32_t r = m | (m << 16);
+        for (int k = 1; k < 9; ++k) r &= (m | (m << 16)) >> k;
+        return r != 0;
+    };
+    int score = 0;
+    if (hasArc(bright)) score = brightSum;
+    if (hasArc(dark) && darkSum > score) score = darkSum;
+    return score;
+}
+
+// 비어 있는 격자 칸마다 가장 강한 코너를 하나씩 추가한다 (기존 점이 있는 칸은 건너뛴다)
+void detectFeatures(const Level& lv) {
+    const int cells = g.gridCols * g.gridRows;
+    for (int i = 0; i < cells; ++i) g.cellScore[i] = 0;
+    for (int i = 0; i < g.count; ++i) {
+        const int cx = static_cast<int>(g.prevPoints[i].x) / g.cellSize;
+        const int cy = static_cast<int>(g.prevPoints[i].y) / g.cellSize;
+        if (cx >= 0 && cx < g.gridCols && cy >= 0 && cy < g.gridRows) g.cellScore[cy * g.gridCols + cx] = -1;
+    }
+
+    int offsets[16];
+    for (int k = 0; k < 16; ++k) offsets[k] = kCircleY[k] * lv.width + kCircleX[k];
+
+    for (int y = kBorder; y < lv.height - kBorder; ++y) {
+        const int cy = y / g.cellSize;
+        if (cy >= g.gridRows) break;
+        for (int x = kBorder; x < lv.width - kBorder; ++x) {
+            const int cx = x / g.cellSize;
+            if (cx >= g.gridCols) break;
+            const int cell = cy * g.gridCols + cx;
+            if (g.cellScore[cell] < 0) continue;
+            const int score = fastScore(lv, x, y, offsets);
+            if (score > g.cellScore[cell]) {
+                g.cellScore[cell] = score;
+                g.cellPoint[cell].x = static_cast<float>(x);
+                g.cellPoint[cell].y = static_cast<float>(y);
+            }
+        }
+    }
+
+    for (int i = 0; i < cells && g.count < g.maxFeatures; ++i) {
+        if (g.cellScore[i] > 0) g.prevPoints[g.count++] = g.cellPoint[i];
+    }
+}
+
+// === Lucas-Kanade ===
+
+inline float sample(const Level& lv, float x, float y) {
+    const int x0 = static_cast<int>(x);
+    const int y0 = static_cast<int>(y);
+    const float tx = x - x0;
+    const float ty = y - y0;
+    const uint8_t* p = lv.data + static_cast<size_t>(y0) * lv.width + x0;
+    const float top = p[0] + (p[1] - p[0]) * tx;
+    const float bottom = p[lv.width] + (p[lv.width + 1] - p[lv.width]) * tx;
+    return top + (bottom - top) * ty;
+}
+
+inline bool insideWindow(const Level& lv, float x, float y) {
+    return x >= kHalfWindow + 1 && y >= kHalfWindow + 1 &&
+           x < lv.width - kHalfWindow - 2 && y < lv.height - kHalfWindow - 2;
+}
+
+// prev 의 점 p 가 next 에서 어디로 갔는지 (Bouguet 의 피라미드 LK). 실패하면 false.
+bool trackPoint(const Pyramid& prev, const Pyramid& next, Point p, Point* out) {
+    float patch[kWindowArea];
+    float gx[kWindowArea];
+    float gy[kWindowArea];
+    float guessX = 0.0f, guessY = 0.0f;
+
+    for (int l = kLevels - 1; l >= 0; --l) {
+        const Level& I = prev.levels[l];
+        const Level& J = next.levels[l];
+        const float scale = 1.0f / static_cast<float>(1 << l);
+        const float px = p.x * scale;
+        const float py = p.y * scale;
+        if (!insideWindow(I, px, py)) return false;
+
+        // 이전 프레임 창의 밝기와 기울기는 반복 동안 변하지 않는다
+        float gxx = 0.0f, gxy = 0.0f, gyy = 0.0f;
+        int k = 0;
+        for (int wy = -kHalfWindow; wy <= kHalfWindow; ++wy) {
+            for (int wx = -kHalfWindow; wx <= kHalfWindow; ++wx, ++k) {
+                const float x = px + wx;
+                const float y = py + wy;
+                patch[k] = sample(I, x, y);
+                gx[k] = 0.5f * (sample(I, x + 1, y) - sample(I, x - 1, y));
+                gy[k] = 0.5f * (sample(I, x, y + 1) - sample(I, x, y - 1));
+                gxx += gx[k] * gx[k];
+                gxy += gx[k] * gy[k];
+                gyy += gy[k] * gy[k];
+            }
+        }
+        const float det = gxx * gyy - gxy * gxy;
+        const float trace = gxx + gyy;
+        const float minEigen = 0.5f * (trace - std::sqrt((gxx - gyy) * (gxx - gyy) + 4.0f * gxy * gxy));
+        if (minEigen / (kWindowArea * 255.0f * 255.0f) < kMinEigen * kMinEigen || det == 0.0f) return false;
+        const float invDet = 1.0f / det;
+
+        float vx = 0.0f, vy = 0.0f;
+        for (int it = 0; it < kMaxIterations; ++it) {
+            const float qx = px + guessX + vx;
+            const float qy = py + guessY + vy;
+            if (!insideWindow(J, qx, qy)) return false;
+            float bx = 0.0f, by = 0.0f;
+            k = 0;
+            for (int wy = -kHalfWindow; wy <= kHalfWindow; ++wy) {
+                for (int wx = -kHalfWindow; wx <= kHalfWindow; ++wx, ++k) {
+                    const float diff = patch[k] - sample(J, qx + wx, qy + wy);
+                    bx += diff * gx[k];
+                    by += diff * gy[k];
+                }
+            }
+            const float ex = (gyy * bx - gxy * by) * invDet;
+            const float ey = (gxx * by - gxy * bx) * invDet;
+            vx += ex;
+            vy += ey;
+            if (ex * ex + ey * ey < 1e-4f) break;
+        }
+
+        if (l > 0) {
+            guessX = 2.0f * (guessX + vx);
+            guessY = 2.0f * (guessY + vy);
+        } else {
+            out->x = p.x + guessX + vx;
+            out->y = p.y + guessY + vy;
+        }
+    }
+    return true;
+}
+
+// === 호모그래피 ===
+
+// n x n 선형계 (첨가 행렬 a: n x (n+1)) 부분 피벗 가우스 소거. 특이하면 false.
+bool solveLinear(double* a, int n, double* x) {
+    const int cols = n + 1;
+    for (int c = 0; c < n; ++c) {
+        int pivot = c;
+        for (int r = c + 1; r < n; ++r) {
+            if (std::fabs(a[r * cols + c]) > std::fabs(a[pivot * cols + c])) pivot = r;
+        }
+        if (std::fabs(a[pivot * cols + c]) < 1e-12) return false;
+        if (pivot != c) {
+            for (int k = 0; k < cols; ++k) {
+                const double t = a[c * cols + k];
+                a[c * cols + k] = a[pivot * cols + k];
+                a[pivot * cols + k] = t;
+            }
+        }
+        for (int r = c + 1; r < n; ++r) {
+            const double f = a[r * cols + c] / a[c * cols + c];
+            for (int k = c; k < cols; ++k) a[r * cols + k] -= f * a[c * cols + k];
+        }
+    }
+    for (int r = n - 1; r >= 0; --r) {
+        double s = a[r * cols + n];
+        for (int k = r + 1; k < n; ++k) s -= a[r * cols + k] * x[k];
+        x[r] = s / a[r * cols + r];
+    }
+    return true;
+}
+
+// src -> dst 호모그래피 (h33 = 1). 좌표는 호출 측에서 정규화해 둔다.
+// n == 4 이면 정확히 풀고, 그보다 많으면 정규 방정식으로 최소제곱을 푼다.
+bool fitHomography(const Point* src, const Point* dst, int n, double* h) {
+    double ata[8 * 9];
+    std::memset(ata, 0, sizeof(ata));
+    for (int i = 0; i < n; ++i) {
+        const double x = src[i].x, y = src[i].y, u = dst[i].x, v = dst[i].y;
+        const double rows[2][9] = {
+            {x, y, 1, 0, 0, 0, -u * x, -u * y, u},
+            {0, 0, 0, x, y, 1, -v * x, -v * y, v},
+        };
+        for (const auto& row : rows) {
+            for (int r = 0; r < 8; ++r) {
+                if (row[r] == 0.0) continue;
+                for (int c = 0; c < 9; ++c) ata[r * 9 + c] += row[r] * row[c];
+            }
+        }
+    }
+    if (!solveLinear(ata, 8, h)) return false;
+    h[8] = 1.0;
+    return true;
+}
+
+inline float reprojectionError2(const double* h, Point s, Point d) {
+    const double w = h[6] * s.x + h[7] * s.y + h[8];
+    if (std::fabs(w) < 1e-9) return 1e30f;
+    const double u = (h[0] * s.x + h[1] * s.y + h[2]) / w;
+    const double v = (h[3] * s.x + h[4] * s.y + h[5]) / w;
+    return static_cast<float>((u - d.x) * (u - d.x) + (v - d.y) * (v - d.y));
+}
+
+inline uint32_t nextRandom() {
+    g.rng = g.rng * 1664525u + 1013904223u;
+    return g.rng >> 8;
+}
+
+// 정규화 좌표계: 중심 원점, 반 폭 = 1
+struct Normalizer {
+    float cx, cy, s;
+    Point apply(Point p) const { return {(p.x - cx) * s, (p.y - cy) * s}; }
+};
+
+// 정규화된 호모그래피 hn 을 픽셀 좌표계로 되돌린다: H = T^-1 * Hn * T
+void denormalize(const double* hn, const Normalizer& n, float* out) {
+    const double T[9] = {n.s, 0, -n.s * n.cx, 0, n.s, -n.s * n.cy, 0, 0, 1};
+    const double Ti[9] = {1 / n.s, 0, n.cx, 0, 1 / n.s, n.cy, 0, 0, 1};
+    double tmp[9], res[9];
+    for (int r = 0; r < 3; ++r)
+        for (int c = 0; c < 3; ++c)
+            tmp[r * 3 + c] = hn[r * 3] * T[c] + hn[r * 3 + 1] * T[3 + c] + hn[r * 3 + 2] * T[6 + c];
+    for (int r = 0; r < 3; ++r)
+        for (int c = 0; c < 3; ++c)
+            res[r * 3 + c] = Ti[r * 3] * tmp[c] + Ti[r * 3 + 1] * tmp[3 + c] + Ti[r * 3 + 2] * tmp[6 + c];
+    for (int i = 0; i < 9; ++i) out[i] = static_cast<float>(res[i] / res[8]);
+}
+
+// 추적한 점 쌍(prevPoints -> nextPoints, count 개)으로 프레임 간 호모그래피를 추정한다.
+// 인라이어는 srcInliers/dstInliers 에 담고 개수를 반환한다.
+int estimateFrameHomography(float* out) {
+    const int n = g.count;
+    if (n < kMinInliers) return 0;
+    const Normalizer norm = {g.width * 0.5f, g.height * 0.5f, 2.0f / g.width};
+    const float thr2 = kRansacThreshold * kRansacThreshold * norm.s * norm.s;
+
+    // srcInliers/dstInliers 를 정규화 좌표 작업 공간으로 먼저 쓴다
+    Point* src = g.srcInliers;
+    Point* dst = g.dstInliers;
+    for (int i = 0; i < n; ++i) {
+        src[i] = norm.apply(g.prevPoints[i]);
+        dst[i] = norm.apply(g.nextPoints[i]);
+    }
+
+    double best[9];
+    int bestInliers = 0;
+    for (int it = 0; it < kRansacIterations; ++it) {
+        int idx[4];
+        for (int k = 0; k < 4; ++k) {
+            bool unique;
+            do {
+                idx[k] = static_cast<int>(nextRandom() % static_cast<uint32_t>(n));
+                unique = true;
+                for (int j = 0; j < k; ++j) unique = unique && idx[j] != idx[k];
+            } while (!unique);
+        }
+        const Point s4[4] = {src[idx[0]], src[idx[1]], src[idx[2]], src[idx[3]]};
+        const Point d4[4] = {dst[idx[0]], dst[idx[1]], dst[idx[2]], dst[idx[3]]};
+        double h[9];
+        if (!fitHomography(s4, d4, 4, h)) continue;
+        int inliers = 0;
+        for (int i = 0; i < n; ++i) inliers += reprojectionError2(h, src[i], dst[i]) < thr2;
+        if (inliers > bestInliers) {
+            bestInliers = inliers;
+            std::memcpy(best, h, sizeof(best));
+        }
+    }
+    if (bestInliers < kMinInliers) return 0;
+
+    // 인라이어만 앞으로 모아 최소제곱으로 다시 맞춘다 (픽셀 좌표 점도 같은 순서로 정리)
+    int m = 0;
+    for (int i = 0; i < n; ++i) {
+        if (reprojectionError2(best, src[i], dst[i]) < thr2) {
+            src[m] = src[i];
+            dst[m] = dst[i];
+            g.nextPoints[m] = g.nextPoints[i];
+            ++m;
+        }
+    }
+    double refined[9];
+    if (fitHomography(src, dst, m, refined)) std::memcpy(best, refined, sizeof(best));
+    denormalize(best, norm, out);
+    return m;
+}
+
+// 장면이 평면에서 크게 벗어나거나 추적이 틀어지면 비정상적인 변환이 나온다
+bool plausible(const float* h) {
+    const float det = h[0] * h[4] - h[1] * h[3];
+    return det > 0.5f && det < 2.0f && std::fabs(h[6]) < 0.01f && std::fabs(h[7]) < 0.01f;
+}
+
+void multiply(const float* a, const float* b, float* out) {
+    float r[9];
+    for (int i = 0; i < 3; ++i)
+        for (int j = 0; j < 3; ++j)
+            r[i * 3 + j] = a[i * 3] * b[j] + a[i * 3 + 1] * b[3 + j] + a[i * 3 + 2] * b[6 + j];
+    for (int i = 0; i < 9; ++i) out[i] = r[i] / r[8];
+}
+
+}  // namespace
+
+// 추적기 초기화. width x height 는 JS 가 넘길 축소 프레임 크기.
+// 아레나를 한 번에 잡고 이후 프레임 처리 중에는 할당하지 않는다.
+WASM_EXPORT int vo_init(int width, int height, int maxFeatures) {
+    if (width < 64 || height < 64 || maxFeatures < kMinInliers || maxFeatures > 1024) return KERNEL_INVALID_ARGS;
+    std::free(g.arena);
+    g = Tracker{};
+
+    const int cellSize = static_cast<int>(std::sqrt(static_cast<float>(width) * height / maxFeatures)) + 1;
+    const int gridCols = (width + cellSize - 1) / cellSize;
+    const int gridRows = (height + cellSize - 1) / cellSize;
+    const int cells = gridCols * gridRows;
+
+    size_t bytes = alignUp(static_cast<size_t>(width) * height * 4);
+    int lw = width, lh = height;
+    for (int l = 0; l < kLevels; ++l) {
+        bytes += 2 * alignUp(static_cast<size_t>(lw) * lh);
+        lw /= 2;
+        lh /= 2;
+    }
+    bytes += 4 * alignUp(sizeof(Point) * maxFeatures);
+    bytes += alignUp(sizeof(int) * cells) + alignUp(sizeof(Point) * cells);
+
+    uint8_t* arena = static_cast<uint8_t*>(std::malloc(bytes));
+    if (!arena) return KERNEL_OUT_OF_MEMORY;
+    size_t offset = 0;
+    auto carve = [&](size_t n) {
+        uint8_t* p = arena + offset;
+        offset += alignUp(n);
+        return p;
+    };
+
+    g.arena = arena;
+    g.width = width;
+    g.height = height;
+    g.maxFeatures = maxFeatures;
+    g.frame = carve(static_cast<size_t>(width) * height * 4);
+    for (int b = 0; b < 2; ++b) {
+        lw = width;
+        lh = height;
+        for (int l = 0; l < kLevels; ++l) {
+            g.pyramids[b].levels[l] = {carve(static_cast<size_t>(lw) * lh), lw, lh};
+            lw /= 2;
+            lh /= 2;
+        }
+    }
+    g.prevPoints = reinterpret_cast<Point*>(carve(sizeof(Point) * maxFeatures));
+    g.nextPoints = reinterpret_cast<Point*>(carve(sizeof(Point) * maxFeatures));
+    g.srcInliers = reinterpret_cast<Point*>(carve(sizeof(Point) * maxFeatures));
+    g.dstInliers = reinterpret_cast<Point*>(carve(sizeof(Point) * maxFeatures));
+    g.gridCols = gridCols;
+    g.gridRows = gridRows;
+    g.cellSize = cellSize;
+    g.cellScore = reinterpret_cast<int*>(carve(sizeof(int) * cells));
+    g.cellPoint = reinterpret_cast<Point*>(carve(sizeof(Point) * cells));
+    g.rng = 0x9e3779b9u;
+    setIdentity(g.homography);
+    return KERNEL_OK;
+}
+
+// JS 가 축소 프레임 RGBA 를 써 넣을 버퍼
+WASM_EXPORT uint8_t* vo_frame_buffer() { return g.frame; }
+
+// 앵커 -> 현재 프레임 호모그래피 (float 9개, 행 우선, 축소 프레임 픽셀 좌표)
+WASM_EXPORT float* vo_homography() { return g.homography; }
+
+// 마지막 프레임의 추적 신뢰도 (인라이어 비율, 0 이면 추적 실패)
+WASM_EXPORT float vo_confidence() { return g.confidence; }
+
+// 현재 프레임을 새 앵커로 삼는다 (HUD 를 옮긴 직후 호출)
+WASM_EXPORT void vo_reset_anchor() { setIdentity(g.homography); }
+
+// vo_frame_buffer() 의 프레임을 처리한다. 인라이어 수를 반환한다 (0 이면 이번 프레임 추적 실패).
+WASM_EXPORT int vo_track_frame() {
+    if (!g.arena) return KERNEL_INVALID_ARGS;
+
+    const int prevIndex = g.current;
+    const int nextIndex = g.hasPrevious ? 1 - g.current : g.current;
+    Pyramid& next = g.pyramids[nextIndex];
+    buildPyramid(next, g.frame);
+
+    int inliers = 0;
+    if (g.hasPrevious && g.count > 0) {
+        const Pyramid& prev = g.pyramids[prevIndex];
+        int tracked = 0;
+        for (int i = 0; i < g.count; ++i) {
+            Point out;
+            if (trackPoint(prev, next, g.prevPoints[i], &out)) {
+                g.prevPoints[tracked] = g.prevPoints[i];
+                g.nextPoints[tracked] = out;
+                ++tracked;
+            }
+        }
+        g.count = tracked;
+
+        float frameH[9];
+        inliers = estimateFrameHomography(frameH);
+        if (inliers > 0 && plausible(frameH)) {
+            multiply(frameH, g.homography, g.homography);
+            g.confidence = static_cast<float>(inliers) / static_cast<float>(tracked);
+            std::memcpy(g.prevPoints, g.nextPoints, sizeof(Point) * inliers);
+            g.count = inliers;
+        } else {
+            inliers = 0;
+            g.confidence = 0.0f;
+            g.count = 0;
+        }
+    } else {
+        g.confidence = 0.0f;
+        g.count = 0;
+    }
+
+    // 점이 절반 아래로 줄면 빈 칸을 새 코너로 채운다
+    if (g.count < g.maxFeatures / 2) detectFeatures(next.levels[0]);
+
+    g.current = nextIndex;
+    g.hasPrevious = true;
+    return inliers;
+}
+
+WASM_EXPORT void vo_shutdown() {
+    std::free(g.arena);
+    g = Tracker{};
+}
@@ -0,0 +1,16 @@
+// Wasm 모듈 공용 정의
+#pragma once
+
+#ifdef __EMSCRIPTEN__
+#include <emscripten/emscripten.h>
+#define WASM_EXPORT extern "C" EMSCRIPTEN_KEEPALIVE
+#else
+#define WASM_EXPORT extern "C"
+#endif
+
+// 내보내는 커널의 반환 코드
+enum KernelStatus {
+    KERNEL_OK = 0,
+    KERNEL_INVALID_ARGS = -1,
+    KERNEL_OUT_OF_MEMORY = -2,
+};
@@ -0,0 +1,720 @@
+// 무손실 WebP(VP8L) 인코더
+//
+// 캔버스가 무손실 WebP 를 만들지 못하는 브라우저(Safari 등)에서 컷아웃 저장용으로 쓴다.
+// 초록 빼기 변환 -> 예측 변환(16x16 블록마다 14개 예측기 중 잔차가 가장 작은 것)을 거친 뒤
+// 앞 픽셀과 같은 값이 이어지는 구간은 거리 1 역참조로, 나머지는 리터럴로 보내고 접두 부호 한 벌로 부호화한다.
+// 컬러 캐시 / 메타 접두 부호 / 색 변환은 쓰지 않는다. 부호 목록을 따로 저장하지 않도록
+// 같은 훑기를 두 번(히스토그램, 쓰기) 돌린다.
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+
+#ifdef __wasm_simd128__
+#include <wasm_simd128.h>
+#endif
+
+#include "wasm_common.h"
+
+namespace {
+
+constexpr int kMaxDimension = 16384;
+constexpr int kPredictorBits = 4;
+constexpr int kNumPredictors = 14;
+constexpr int kNumLiteralCodes = 256;
+constexpr int kNumLengthCodes = 24;
+constexpr int kGreenAlphabet = kNumLiteralCodes + kNumLengthCodes;
+constexpr int kNumDistanceCodes = 40;
+constexpr int kMaxCodeLength = 15;
+constexpr int kNumCodeLengthCodes = 19;
+constexpr int kMaxCodeLengthCodeLength = 7;
+constexpr int kMinRunLength = 4;
+constexpr int kMaxRunLength = 4096;
+// 평면 거리 부호 2 = (1, 0), 곧 바로 왼쪽 픽셀
+constexpr int kLeftDistanceCode = 2;
+constexpr size_t kRiffHeaderBytes = 20;
+
+const uint8_t kCodeLengthCodeOrder[kNumCodeLengthCodes] = {
+    17, 18, 0, 1, 2, 3, 4, 5, 16, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15,
+};
+
+// === 비트 쓰기 (LSB 먼저) ===
+
+struct BitWriter {
+    uint8_t* buf = nullptr;
+    size_t size = 0;
+    size_t cap = 0;
+    uint64_t acc = 0;
+    int used = 0;
+    bool failed = false;
+
+    void reserve(size_t need) {
+        if (failed || size + need <= cap) return;
+        size_t next = cap ? cap * 2 : 1 << 16;
+        while (next < size + need) next *= 2;
+        uint8_t* grown = static_cast<uint8_t*>(std::realloc(buf, next));
+        if (!grown) {
+            failed = true;
+            return;
+        }
+        buf = grown;
+        cap = next;
+    }
+
+    void putBits(uint32_t value, int n) {
+        acc |= static_cast<uint64_t>(value) << used;
+        used += n;
+        if (used < 32) return;
+        reserve(4);
+        if (failed) return;
+        for (int i = 0; i < 4; ++i) buf[size++] = static_cast<uint8_t>(acc >> (8 * i));
+        acc >>= 32;
+        used -= 32;
+    }
+
+    void flush() {
+        reserve(8);
+        if (failed) return;
+        while (used > 0) {
+            buf[size++] = static_cast<uint8_t>(acc);
+            acc >>= 8;
+            used -= 8;
+        }
+        used = 0;
+        acc = 0;
+    }
+};
+
+// === 접두 부호 ===
+
+struct PrefixCode {
+    uint8_t* lengths;
+    uint16_t* codes;   // 비트 순서를 뒤집어 둔 부호 (LSB 먼저 쓰기용)
+    int size;
+};
+
+// 출현 횟수로 길이 제한 허프만 부호 길이를 구한다. 길이를 넘으면 횟수를 반으로 줄여 다시 만든다.
+// 쓰인 기호가 하나뿐이면 그 기호 길이는 1 로 두고 쓸 때는 0비트를 쓴다 (디코더가 같은 특례를 둔다).
+bool buildCodeLengths(const uint32_t* counts, int n, int maxLength, uint8_t* lengths) {
+    std::memset(lengths, 0, n);
+    int used = 0;
+    for (int i = 0; i < n; ++i) used += counts[i] != 0;
+    if (used == 0) return true;
+    if (used == 1) {
+        for (int i = 0; i < n; ++i) {
+            if (counts[i]) lengths[i] = 1;
+        }
+        return true;
+    }
+
+    // 잎 n 개 + 내부 노드 n-1 개
+    const int maxNodes = 2 * n;
+    uint32_t* weight = static_cast<uint32_t*>(std::malloc(sizeof(uint32_t) * maxNodes));
+    int* parent = static_cast<int*>(std::malloc(sizeof(int) * maxNodes));
+    uint32_t* scaled = static_cast<uint32_t*>(std::malloc(sizeof(uint32_t) * n));
+    if (!weight || !parent || !scaled) {
+        std::free(weight);
+        std::free(parent);
+        std::free(scaled);
+        return false;
+    }
+    std::memcpy(scaled, counts, sizeof(uint32_t) * n);
+
+    for (;;) {
+        int nodes = 0;
+        int leafOf[kGreenAlphabet];
+        for (int i = 0; i < n; ++i) {
+            if (!scaled[i]) continue;
+            leafOf[nodes] = i;
+            weight[nodes] = scaled[i];
+            parent[nodes] = -1;
+            ++nodes;
+        }
+        const int leaves = nodes;
+        // 알파벳이 작아 (최대 280) 매번 가장 가벼운 두 노드를 선형 탐색으로 고른다
+        for (int merged = 0; merged < leaves - 1; ++merged) {
+            int a = -1;
+            int b = -1;
+            for (int i = 0; i < nodes; ++i) {
+                if (parent[i] != -1) continue;
+                if (a < 0 || weight[i] < weight[a]) {
+                    b = a;
+                    a = i;
+                } else if (b < 0 || weight[i] < weight[b]) {
+                    b = i;
+                }
+            }
+            weight[nodes] = weight[a] + weight[b];
+            parent[nodes] = -1;
+            parent[a] = nodes;
+            parent[b] = nodes;
+            ++nodes;
+        }
+
+        int deepest = 0;
+        for (int i = 0; i < leaves; ++i) {
+            int depth = 0;
+            for (int p = parent[i]; p != -1; p = parent[p]) ++depth;
+            lengths[leafOf[i]] = static_cast<uint8_t>(depth > 255 ? 255 : depth);
+            if (depth > deepest) deepest = depth;
+        }
+        if (deepest <= maxLength) break;
+        for (int i = 0; i < n; ++i) {
+            if (scaled[i]) scaled[i] = (scaled[i] + 1) >> 1;
+        }
+    }
+
+    std::free(weight);
+    std::free(parent);
+    std::free(scaled);
+    return true;
+}
+
+uint32_t reverseBits(uint32_t code, int length) {
+    uint32_t out = 0;
+    for (int i = 0; i < length; ++i) {
+        out = (out << 1) | (code & 1);
+        code >>= 1;
+    }
+    return out;
+}
+
+// 정준 부호 (길이 순, 같은 길이는 기호 순)
+void assignCodes(PrefixCode& code) {
+    int count[kMaxCodeLength + 1] = {0};
+    for (int i = 0; i < code.size; ++i) count[code.lengths[i]]++;
+    count[0] = 0;
+    uint32_t next[kMaxCodeLength + 2] = {0};
+    uint32_t value = 0;
+    for (int len = 1; len <= kMaxCodeLength; ++len) {
+        value = (value + count[len - 1]) << 1;
+        next[len] = value;
+    }
+    for (int i = 0; i < code.size; ++i) {
+        const int len = code.lengths[i];
+        code.codes[i] = len ? static_cast<uint16_t>(reverseBits(next[len]++, len)) : 0;
+    }
+}
+
+// 쓰인 기호가 하나뿐인 부호는 0비트, 아니면 부호 길이만큼 쓴다
+struct SymbolWriter {
+    const PrefixCode* code;
+    bool single;
+
+    void put(BitWriter& bw, int symbol) const {
+        if (!single) bw.putBits(code->codes[symbol], code->lengths[symbol]);
+    }
+};
+
+int usedSymbols(const PrefixCode& code, int* first, int* second) {
+    int used = 0;
+    for (int i = 0; i < code.size; ++i) {
+        if (!code.lengths[i]) continue;
+        if (used == 0) *first = i;
+        else if (used == 1) *second = i;
+        ++used;
+    }
+    return used;
+}
+
+// 부호 길이 목록 -> 부호 길이 부호(0..18) 기호열. extra 에 반복 횟수를 둔다.
+int tokenizeLengths(const uint8_t* lengths, int n, uint8_t* tokens, uint8_t* extra) {
+    int count = 0;
+    int i = 0;
+    while (i < n) {
+        const uint8_t value = lengths[i];
+        int run = 1;
+        while (i + run < n && lengths[i + run] == value) ++run;
+        i += run;
+        if (value == 0) {
+            while (run >= 11) {
+                const int take = run < 138 ? run : 138;
+                tokens[count] = 18;
+                extra[count++] = static_cast<uint8_t>(take - 11);
+                run -= take;
+            }
+            if (run >= 3) {
+                tokens[count] = 17;
+                extra[count++] = static_cast<uint8_t>(run - 3);
+                run = 0;
+            }
+            while (run-- > 0) {
+                tokens[count] = 0;
+                extra[count++] = 0;
+            }
+        } else {
+            // 16 은 직전 0 이 아닌 길이를 반복하므로 구간 첫 값은 그대로 쓴다
+            tokens[count] = value;
+            extra[count++] = 0;
+            --run;
+            while (run >= 3) {
+                const int take = run < 6 ? run : 6;
+                tokens[count] = 16;
+                extra[count++] = static_cast<uint8_t>(take - 3);
+                run -= take;
+            }
+            while (run-- > 0) {
+                tokens[count] = value;
+                extra[count++] = 0;
+            }
+        }
+    }
+    return count;
+}
+
+// 접두 부호 하나를 기록한다. 기호가 둘 이하이고 모두 8비트 안이면 단순 부호를 쓴다.
+bool writePrefixCode(BitWriter& bw, const PrefixCode& code) {
+    int first = 0;
+    int second = 0;
+    const int used = usedSymbols(code, &first, &second);
+    if (used <= 2 && first < 256 && (used < 2 || second < 256)) {
+        bw.putBits(1, 1);
+        bw.putBits(used == 2 ? 1 : 0, 1);
+        if (first < 2) {
+            bw.putBits(0, 1);
+            bw.putBits(first, 1);
+        } else {
+            bw.putBits(1, 1);
+            bw.putBits(first, 8);
+        }
+        if (used == 2) bw.putBits(second, 8);
+        return true;
+    }
+
+    uint8_t* tokens = static_cast<uint8_t*>(std::malloc(code.size * 2));
+    if (!tokens) return false;
+    uint8_t* extra = tokens + code.size;
+    const int tokenCount = tokenizeLengths(code.lengths, code.size, tokens, extra);
+
+    uint32_t histogram[kNumCodeLengthCodes] = {0};
+    for (int i = 0; i < tokenCount; ++i) histogram[tokens[i]]++;
+    uint8_t clLengths[kNumCodeLengthCodes];
+    uint16_t clCodes[kNumCodeLengthCodes];
+    buildCodeLengths(histogram, kNumCodeLengthCodes, kMaxCodeLengthCodeLength, clLengths);
+    PrefixCode clCode = {clLengths, clCodes, kNumCodeLengthCodes};
+    assignCodes(clCode);
+    int clFirst = 0;
+    int clSecond = 0;
+    const SymbolWriter cl = {&clCode, usedSymbols(clCode, &clFirst, &clSecond) == 1};
+
+    int written = kNumCodeLengthCodes;
+    while (written > 4 && clLengths[kCodeLengthCodeOrder[written - 1]] == 0) --written;
+    bw.putBits(0, 1);
+    bw.putBits(written - 4, 4);
+    for (int i = 0; i < written; ++i) bw.putBits(clLengths[kCodeLengthCodeOrder[i]], 3);
+    // max_symbol 을 따로 적지 않고 알파벳 전체를 쓴다
+    bw.putBits(0, 1);
+    for (int i = 0; i < tokenCount; ++i) {
+        cl.put(bw, tokens[i]);
+        if (tokens[i] == 16) bw.putBits(extra[i], 2);
+        else if (tokens[i] == 17) bw.putBits(extra[i], 3);
+        else if (tokens[i] == 18) bw.putBits(extra[i], 7);
+    }
+    std::free(tokens);
+    return true;
+}
+
+// 길이/거리 값 -> (접두 기호, 추가 비트 수, 추가 비트 값)
+inline void prefixEncode(int value, int* symbol, int* extraBits, int* extraValue) {
+    const int d = value - 1;
+    if (d < 4) {
+        *symbol = d;
+        *extraBits = 0;
+        *extraValue = 0;
+        return;
+    }
+    int high = 31 - __builtin_clz(static_cast<unsigned>(d));
+    const int second = (d >> (high - 1)) & 1;
+    *extraBits = high - 1;
+    *symbol = 2 * high + second;
+    *extraValue = d & ((1 << *extraBits) - 1);
+}
+
+// === 엔트로피 부호화 이미지 ===
+
+struct Histograms {
+    uint32_t green[kGreenAlphabet];
+    uint32_t red[kNumLiteralCodes];
+    uint32_t blue[kNumLiteralCodes];
+    uint32_t alpha[kNumLiteralCodes];
+    uint32_t distance[kNumDistanceCodes];
+};
+
+struct Codes {
+    uint8_t lengths[kGreenAlphabet + 3 * kNumLiteralCodes + kNumDistanceCodes];
+    uint16_t codes[kGreenAlphabet + 3 * kNumLiteralCodes + kNumDistanceCodes];
+    PrefixCode green, red, blue, alpha, distance;
+
+    void init() {
+        uint8_t* l = lengths;
+        uint16_t* c = codes;
+        green = {l, c, kGreenAlphabet};
+        red = {l += kGreenAlphabet, c += kGreenAlphabet, kNumLiteralCodes};
+        blue = {l += kNumLiteralCodes, c += kNumLiteralCodes, kNumLiteralCodes};
+        alpha = {l += kNumLiteralCodes, c += kNumLiteralCodes, kNumLiteralCodes};
+        distance = {l + kNumLiteralCodes, c + kNumLiteralCodes, kNumDistanceCodes};
+    }
+};
+
+// 앞 픽셀과 같은 값이 kMinRunLength 개 이상 이어지면 역참조 하나로, 아니면 리터럴로 내보낸다.
+// 히스토그램 훑기와 쓰기 훑기가 같은 결정을 내리도록 이 함수 하나로 둘 다 처리한다.
+template <class Sink>
+void scanImage(const uint32_t* argb, size_t count, Sink& sink) {
+    size_t i = 0;
+    while (i < count) {
+        if (i > 0) {
+            size_t run = 0;
+            const uint32_t prev = argb[i - 1];
+            while (i + run < count && run < static_cast<size_t>(kMaxRunLength) && argb[i + run] == prev) ++run;
+            if (run >= static_cast<size_t>(kMinRunLength)) {
+                sink.copy(static_cast<int>(run));
+                i += run;
+                continue;
+            }
+        }
+        sink.literal(argb[i]);
+        ++i;
+    }
+}
+
+struct HistogramSink {
+    Histograms* h;
+
+    void literal(uint32_t p) {
+        h->alpha[p >> 24]++;
+        h->red[(p >> 16) & 0xff]++;
+        h->green[(p >> 8) & 0xff]++;
+        h->blue[p & 0xff]++;
+    }
+    void copy(int length) {
+        int symbol, bits, value;
+        prefixEncode(length, &symbol, &bits, &value);
+        h->green[kNumLiteralCodes + symbol]++;
+        prefixEncode(kLeftDistanceCode, &symbol, &bits, &value);
+        h->distance[symbol]++;
+    }
+};
+
+struct WriteSink {
+    BitWriter* bw;
+    SymbolWriter green, red, blue, alpha, distance;
+
+    void literal(uint32_t p) {
+        green.put(*bw, (p >> 8) & 0xff);
+        red.put(*bw, (p >> 16) & 0xff);
+        blue.put(*bw, p & 0xff);
+        alpha.put(*bw, p >> 24);
+    }
+    void copy(int length) {
+        int symbol, bits, value;
+        prefixEncode(length, &symbol, &bits, &value);
+        green.put(*bw, kNumLiteralCodes + symbol);
+        bw->putBits(value, bits);
+        prefixEncode(kLeftDistanceCode, &symbol, &bits, &value);
+        distance.put(*bw, symbol);
+        bw->putBits(value, bits);
+    }
+};
+
+SymbolWriter symbolWriter(const PrefixCode& code) {
+    int first = 0;
+    int second = 0;
+    return {&code, usedSymbols(code, &first, &second) <= 1};
+}
+
+// 컬러 캐시 비트, (주 이미지면) 메타 접두 부호 비트, 접두 부호 다섯 개, 픽셀 순으로 쓴다.
+// 역참조가 없으면 거리 부호는 기호 0 하나짜리 단순 부호가 된다.
+int writeEntropyImage(BitWriter& bw, const uint32_t* argb, size_t count, bool mainImage) {
+    Histograms* h = static_cast<Histograms*>(std::calloc(1, sizeof(Histograms)));
+    Codes* codes = static_cast<Codes*>(std::malloc(sizeof(Codes)));
+    if (!h || !codes) {
+        std::free(h);
+        std::free(codes);
+        return KERNEL_OUT_OF_MEMORY;
+    }
+    HistogramSink histogramSink = {h};
+    scanImage(argb, count, histogramSink);
+
+    codes->init();
+    const bool ok = buildCodeLengths(h->green, kGreenAlphabet, kMaxCodeLength, codes->green.lengths) &&
+                    buildCodeLengths(h->red, kNumLiteralCodes, kMaxCodeLength, codes->red.lengths) &&
+                    buildCodeLengths(h->blue, kNumLiteralCodes, kMaxCodeLength, codes->blue.lengths) &&
+                    buildCodeLengths(h->alpha, kNumLiteralCodes, kMaxCodeLength, codes->alpha.lengths) &&
+                    buildCodeLengths(h->distance, kNumDistanceCodes, kMaxCodeLength, codes->distance.lengths);
+    std::free(h);
+    if (!ok) {
+        std::free(codes);
+        return KERNEL_OUT_OF_MEMORY;
+    }
+
+    PrefixCode* order[5] = {&codes->green, &codes->red, &codes->blue, &codes->alpha, &codes->distance};
+    bw.putBits(0, 1);                  // 컬러 캐시 없음
+    if (mainImage) bw.putBits(0, 1);   // 메타 접두 부호 없음 (부호 한 벌)
+    int status = KERNEL_OK;
+    for (PrefixCode* code : order) {
+        assignCodes(*code);
+        if (!writePrefixCode(bw, *code)) status = KERNEL_OUT_OF_MEMORY;
+    }
+    if (status == KERNEL_OK) {
+        WriteSink writeSink = {&bw, symbolWriter(codes->green), symbolWriter(codes->red), symbolWriter(codes->blue),
+                               symbolWriter(codes->alpha), symbolWriter(codes->distance)};
+        scanImage(argb, count, writeSink);
+    }
+    std::free(codes);
+    return status;
+}
+
+// === 변환 ===
+
+// RGBA 바이트 -> ARGB 정수 (리틀엔디언 메모리에서 B, G, R, A 순)
+void rgbaToArgb(const uint8_t* rgba, uint32_t* argb, size_t count, bool* hasAlpha) {
+    size_t i = 0;
+    bool alpha = false;
+#ifdef __wasm_simd128__
+    const v128_t opaque = wasm_i32x4_splat(static_cast<int32_t>(0xff000000u));
+    v128_t alphaAnd = opaque;
+    for (; i + 4 <= count; i += 4) {
+        const v128_t v = wasm_v128_load(rgba + i * 4);
+        alphaAnd = wasm_v128_and(alphaAnd, v);
+        wasm_v128_store(argb + i, wasm_i8x16_shuffle(v, v, 2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15));
+    }
+    alpha = !wasm_i32x4_all_true(wasm_i32x4_eq(alphaAnd, opaque));
+#endif
+    for (; i < count; ++i) {
+        const uint8_t* p = rgba + i * 4;
+        argb[i] = (static_cast<uint32_t>(p[3]) << 24) | (static_cast<uint32_t>(p[0]) << 16) |
+                  (static_cast<uint32_t>(p[1]) << 8) | p[2];
+        alpha = alpha || p[3] != 255;
+    }
+    *hasAlpha = alpha;
+}
+
+// 빨강, 파랑에서 초록을 뺀다 (채널별 mod 256)
+void subtractGreen(uint32_t* argb, size_t count) {
+    size_t i = 0;
+#ifdef __wasm_simd128__
+    const v128_t lowMask = wasm_i32x4_splat(0xff);
+    const v128_t redMask = wasm_i32x4_splat(0xff0000);
+    for (; i + 4 <= count; i += 4) {
+        const v128_t v = wasm_v128_load(argb + i);
+        const v128_t green = wasm_v128_or(wasm_v128_and(wasm_u32x4_shr(v, 8), lowMask),
+                                          wasm_v128_and(wasm_i32x4_shl(v, 8), redMask));
+        wasm_v128_store(argb + i, wasm_i8x16_sub(v, green));
+    }
+#endif
+    for (; i < count; ++i) {
+        const uint32_t v = argb[i];
+        const uint32_t green = (v >> 8) & 0xff;
+        const uint32_t rb = ((v & 0x00ff00ffu) + 0x01000100u - ((green << 16) | green)) & 0x00ff00ffu;
+        argb[i] = (v & 0xff00ff00u) | rb;
+    }
+}
+
+// 채널별 (a - b) mod 256
+void subtractPixels(uint32_t* dst, const uint32_t* pred, int n) {
+    int i = 0;
+#ifdef __wasm_simd128__
+    for (; i + 4 <= n; i += 4) {
+        wasm_v128_store(dst + i, wasm_i8x16_sub(wasm_v128_load(dst + i), wasm_v128_load(pred + i)));
+    }
+#endif
+    for (; i < n; ++i) {
+        const uint32_t a = dst[i];
+        const uint32_t b = pred[i];
+        const uint32_t ag = 0x00ff00ffu + (a & 0xff00ff00u) - (b & 0xff00ff00u);
+        const uint32_t rb = 0xff00ff00u + (a & 0x00ff00ffu) - (b & 0x00ff00ffu);
+        dst[i] = (ag & 0xff00ff00u) | (rb & 0x00ff00ffu);
+    }
+}
+
+inline uint32_t average2(uint32_t a, uint32_t b) {
+    return (((a ^ b) & 0xfefefefeu) >> 1) + (a & b);
+}
+
+inline int channel(uint32_t p, int shift) { return static_cast<int>((p >> shift) & 0xff); }
+
+inline int clamp255(int v) { return v < 0 ? 0 : (v > 255 ? 255 : v); }
+
+inline uint32_t select(uint32_t left, uint32_t top, uint32_t topLeft) {
+    int distLeft = 0;
+    int distTop = 0;
+    for (int shift = 0; shift < 32; shift += 8) {
+        distLeft += std::abs(channel(top, shift) - channel(topLeft, shift));
+        distTop += std::abs(channel(left, shift) - channel(topLeft, shift));
+    }
+    return distLeft < distTop ? left : top;
+}
+
+inline uint32_t clampAddSubtractFull(uint32_t a, uint32_t b, uint32_t c) {
+    uint32_t out = 0;
+    for (int shift = 0; shift < 32; shift += 8) {
+        out |= static_cast<uint32_t>(clamp255(channel(a, shift) + channel(b, shift) - channel(c, shift))) << shift;
+    }
+    return out;
+}
+
+inline uint32_t clampAddSubtractHalf(uint32_t a, uint32_t b) {
+    uint32_t out = 0;
+    for (int shift = 0; shift < 32; shift += 8) {
+        const int ca = channel(a, shift);
+        out |= static_cast<uint32_t>(clamp255(ca + (ca - channel(b, shift)) / 2)) << shift;
+    }
+    return out;
+}
+
+// 첫 행이 아니고 첫 열이 아닌 픽셀의 예측값. p 는 현재 픽셀, width 는 행 길이.
+// 오른쪽 끝 열의 TR 은 현재 행의 첫 픽셀이 되는데, 메모리상 p - width + 1 이 바로 그 자리다.
+inline uint32_t predict(int mode, const uint32_t* p, int width) {
+    const uint32_t left = p[-1];
+    const uint32_t top = p[-width];
+    const uint32_t topRight = p[-width + 1];
+    const uint32_t topLeft = p[-width - 1];
+    switch (mode) {
+        case 0: return 0xff000000u;
+        case 1: return left;
+        case 2: return top;
+        case 3: return topRight;
+        case 4: return topLeft;
+        case 5: return average2(average2(left, topRight), top);
+        case 6: return average2(left, topLeft);
+        case 7: return average2(left, top);
+        case 8: return average2(topLeft, top);
+        case 9: return average2(top, topRight);
+        case 10: return average2(average2(left, topLeft), average2(top, topRight));
+        case 11: return select(left, top, topLeft);
+        case 12: return clampAddSubtractFull(left, top, topLeft);
+        default: return clampAddSubtractHalf(average2(left, top), topLeft);
+    }
+}
+
+inline int residualCost(uint32_t pixel, uint32_t pred) {
+    int cost = 0;
+    for (int shift = 0; shift < 32; shift += 8) {
+        const int8_t d = static_cast<int8_t>(channel(pixel, shift) - channel(pred, shift));
+        cost += d < 0 ? -d : d;
+    }
+    return cost;
+}
+
+// 블록마다 잔차 절댓값 합이 가장 작은 예측기를 고른다. 첫 행/첫 열은 예측기가 고정이라 빼고 센다.
+// 비용은 한 행 건너 한 번씩만 세서 시간을 줄인다.
+void choosePredictors(const uint32_t* argb, int width, int height, uint32_t* modes, int blocksWide, int blocksHigh) {
+    const int blockSize = 1 << kPredictorBits;
+    for (int by = 0; by < blocksHigh; ++by) {
+        for (int bx = 0; bx < blocksWide; ++bx) {
+            const int x0 = bx * blockSize > 0 ? bx * blockSize : 1;
+            const int y0 = by * blockSize > 0 ? by * blockSize : 1;
+            const int x1 = (bx + 1) * blockSize < width ? (bx + 1) * blockSize : width;
+            const int y1 = (by + 1) * blockSize < height ? (by + 1) * blockSize : height;
+            int best = 11;
+            int bestCost = -1;
+            for (int mode = 0; mode < kNumPredictors; ++mode) {
+                int cost = 0;
+                for (int y = y0; y < y1; y += 2) {
+                    const uint32_t* row = argb + static_cast<size_t>(y) * width;
+                    for (int x = x0; x < x1; ++x) cost += residualCost(row[x], predict(mode, row + x, width));
+                }
+                if (bestCost < 0 || cost < bestCost) {
+                    bestCost = cost;
+                    best = mode;
+                }
+            }
+            modes[static_cast<size_t>(by) * blocksWide + bx] = 0xff000000u | (static_cast<uint32_t>(best) << 8);
+        }
+    }
+}
+
+// 아래 행부터 잔차로 바꾼다. 위/왼쪽 이웃은 아직 원본이므로 같은 버퍼에서 처리할 수 있다.
+void applyPredictors(uint32_t* argb, int width, int height, const uint32_t* modes, int blocksWide, uint32_t* predRow) {
+    for (int y = height - 1; y >= 0; --y) {
+        uint32_t* row = argb + static_cast<size_t>(y) * width;
+        if (y == 0) {
+            predRow[0] = 0xff000000u;
+            for (int x = 1; x < width; ++x) predRow[x] = row[x - 1];
+        } else {
+            predRow[0] = row[-width];
+            const uint32_t* modeRow = modes + static_cast<size_t>(y >> kPredictorBits) * blocksWide;
+            for (int x = 1; x < width; ++x) {
+                predRow[x] = predict((modeRow[x >> kPredictorBits] >> 8) & 0xff, row + x, width);
+            }
+        }
+        subtractPixels(row, predRow, width);
+    }
+}
+
+void putLE32(uint8_t* p, uint32_t v) {
+    for (int i = 0; i < 4; ++i) p[i] = static_cast<uint8_t>(v >> (8 * i));
+}
+
+}  // namespace
+
+// RGBA 버퍼(getImageData 결과와 같은 배치)를 무손실 WebP 파일로 부호화한다.
+// 결과는 malloc 으로 잡아 *out 에 넘기고 크기를 *outSize 에 쓴다. 호출 측이 free 한다.
+WASM_EXPORT int webp_encode_lossless(const uint8_t* rgba, int width, int height, uint8_t** out, uint32_t* outSize) {
+    if (!rgba || !out || !outSize || width <= 0 || height <= 0 || width > kMaxDimension || height > kMaxDimension) {
+        return KERNEL_INVALID_ARGS;
+    }
+    *out = nullptr;
+    *outSize = 0;
+
+    const size_t count = static_cast<size_t>(width) * height;
+    const int blocksWide = (width + (1 << kPredictorBits) - 1) >> kPredictorBits;
+    const int blocksHigh = (height + (1 << kPredictorBits) - 1) >> kPredictorBits;
+    const size_t modeCount = static_cast<size_t>(blocksWide) * blocksHigh;
+    uint32_t* argb = static_cast<uint32_t*>(std::malloc(sizeof(uint32_t) * (count + modeCount + width)));
+    if (!argb) return KERNEL_OUT_OF_MEMORY;
+    uint32_t* modes = argb + count;
+    uint32_t* predRow = modes + modeCount;
+
+    bool hasAlpha = false;
+    rgbaToArgb(rgba, argb, count, &hasAlpha);
+    subtractGreen(argb, count);
+    choosePredictors(argb, width, height, modes, blocksWide, blocksHigh);
+    applyPredictors(argb, width, height, modes, blocksWide, predRow);
+
+    BitWriter bw;
+    bw.reserve(kRiffHeaderBytes + count / 4);
+    bw.size = kRiffHeaderBytes;
+    bw.putBits(0x2f, 8);
+    bw.putBits(width - 1, 14);
+    bw.putBits(height - 1, 14);
+    bw.putBits(hasAlpha ? 1 : 0, 1);
+    bw.putBits(0, 3);
+    // 변환은 적용한 순서대로 적는다 (디코더는 역순으로 되돌린다)
+    bw.putBits(1, 1);
+    bw.putBits(2, 2);                      // SUBTRACT_GREEN
+    bw.putBits(1, 1);
+    bw.putBits(0, 2);                      // PREDICTOR
+    bw.putBits(kPredictorBits - 2, 3);
+    int status = writeEntropyImage(bw, modes, modeCount, false);
+    bw.putBits(0, 1);                      // 변환 끝
+    if (status == KERNEL_OK) status = writeEntropyImage(bw, argb, count, true);
+    std::free(argb);
+    bw.flush();
+    if (bw.failed) status = KERNEL_OUT_OF_MEMORY;
+    if (status != KERNEL_OK) {
+        std::free(bw.buf);
+        return status;
+    }
+
+    // RIFF 컨테이너 (VP8L 청크 하나, 홀수 길이면 1바이트 채움)
+    const uint32_t payload = static_cast<uint32_t>(bw.size - kRiffHeaderBytes);
+    if (payload & 1) {
+        bw.reserve(1);
+        if (bw.failed) {
+            std::free(bw.buf);
+            return KERNEL_OUT_OF_MEMORY;
+        }
+        bw.buf[bw.size++] = 0;
+    }
+    uint8_t* header = bw.buf;
+    std::memcpy(header, "RIFF", 4);
+    putLE32(header + 4, static_cast<uint32_t>(bw.size - 8));
+    std::memcpy(header + 8, "WEBPVP8L", 8);
+    putLE32(header + 16, payload);
+
+    *out = bw.buf;
+    *outSize = static_cast<uint32_t>(bw.size);
+    return KERNEL_OK;
+}